@@ -0,0 +1,44 @@
+#ifndef AUDIOSYSTEM_HPP
+#define AUDIOSYSTEM_HPP
+
+#include "GameEvents.hpp"
+#include "VoicePool.hpp"
+#include <SFML/Audio.hpp>
+#include <atomic>
+#include <thread>
+
+// Plays every sound effect on a dedicated thread, through a fixed pool of
+// voices (see VoicePool) so overlapping effects don't cut each other off.
+// Gameplay only pushes GameEvents into events(); it never touches sf::Sound,
+// so audio-device latency can't stall the simulation.
+class AudioSystem {
+public:
+    AudioSystem();
+    ~AudioSystem();
+
+    AudioSystem(const AudioSystem&) = delete;
+    AudioSystem& operator=(const AudioSystem&) = delete;
+
+    // Single producer: the simulation thread
+    GameEventQueue& events() { return m_events; }
+
+private:
+    void workerLoop();
+    void handle(const GameEvent& event);
+
+    GameEventQueue m_events;
+    std::atomic<bool> m_running;
+
+    // Decoded once (SoundBufferCache), played through the shared voices
+    const sf::SoundBuffer& m_stompBuffer;
+    const sf::SoundBuffer& m_powerupBuffer;
+    const sf::SoundBuffer& m_goalBuffer;
+    const sf::SoundBuffer& m_deathBuffer;
+    const sf::SoundBuffer& m_jumpBuffer;
+    const sf::SoundBuffer& m_menuBuffer;
+    VoicePool m_voices;
+
+    std::thread m_worker; // Declared last: starts after the voices exist
+};
+
+#endif // AUDIOSYSTEM_HPP
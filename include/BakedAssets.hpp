@@ -0,0 +1,31 @@
+#ifndef BAKEDASSETS_HPP
+#define BAKEDASSETS_HPP
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+
+// Sprites that are drawn much smaller than their source art, pre-scaled to
+// their size on screen. Each asset is a strip of frames (crops of one
+// source image) resampled with an area filter and laid out left to right,
+// so a sprite draws at scale 1 and switches frames with frameRect().
+// tools/bake_assets.cpp writes them to assets/baked/ at build time; when a
+// file is missing TextureCache::getBaked() bakes it in memory instead.
+struct BakedAsset {
+    const char* name;   // assets/baked/<name>.png
+    const char* source; // Original image
+    std::vector<sf::IntRect> frames; // Areas of the source
+    sf::Vector2u frameSize;          // Display size of every frame
+
+    std::string path() const;
+    sf::IntRect frameRect(int frame) const;
+
+    // Looks 'name' up in all(); nullptr if unknown
+    static const BakedAsset* find(const std::string& name);
+    static const std::vector<BakedAsset>& all();
+
+    // Resamples the frames out of 'source' into the baked strip
+    sf::Image bake(const sf::Image& source) const;
+};
+
+#endif // BAKEDASSETS_HPP
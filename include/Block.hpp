@@ -1,7 +1,10 @@
 #pragma once
 #include "Physics.hpp"
+#include "RenderSnapshot.hpp"
 #include <SFML/Graphics.hpp>
 
+class StateWriter;
+class StateReader;
 
 class Block {
 public:
@@ -9,7 +12,7 @@ public:
 
   Block(Physics &physics, float x, float y);
   
-  // Disable copying to avoid expensive texture copies and sprite pointer issues
+  // Disable copying to avoid duplicating the static physics body
   Block(const Block&) = delete;
   Block& operator=(const Block&) = delete;
 
@@ -18,7 +21,8 @@ public:
   Block& operator=(Block&& other) noexcept;
 
   bool hit(); // Returns true if item should spawn (first hit only)
-  void draw(sf::RenderWindow &window);
+  void draw(sf::RenderTarget &target);
+  void snapshot(RenderSnapshot &snapshot) const;
   sf::FloatRect getBounds() const;
   bool isActive() const { return m_active; }
   void update(float dt); // For animations if needed
@@ -26,13 +30,16 @@ public:
   // Position helper for spawning items
   sf::Vector2f getPosition() const;
 
+  // Savestate (the static body never moves and is not stored)
+  void saveState(StateWriter &writer) const;
+  bool loadState(StateReader &reader);
+
 private:
   void updateTexture();
 
   Physics *m_physics;
   b2BodyId m_bodyId;
-  sf::Texture m_texture; 
-  sf::Sprite m_sprite;
+  sf::Sprite m_sprite; // Texture is owned by TextureCache
 
   Type m_type;
   bool m_active;
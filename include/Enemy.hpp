@@ -3,32 +3,51 @@
 
 #include <SFML/Graphics.hpp>
 #include "Physics.hpp"
+#include "RenderSnapshot.hpp"
+
+class StateWriter;
+class StateReader;
+struct BodyState;
 
 class Enemy {
 public:
     enum class State { Walking, Stomped, Dead };
 
-    Enemy(Physics& physics, float x, float y);
+    Enemy(Physics& physics, const sf::Texture& texture, float x, float y);
     virtual ~Enemy();
 
     virtual void update(float dt);
-    virtual void draw(sf::RenderWindow& window);
+    virtual void draw(sf::RenderTarget& target);
+    virtual void snapshot(RenderSnapshot& snapshot) const;
     virtual void stomp();  // Called when Mario jumps on the enemy
     
     bool isAlive() const { return m_state != State::Dead; }
     bool isStomped() const { return m_state == State::Stomped; }
     sf::FloatRect getBounds() const { return m_sprite.getGlobalBounds(); }
     sf::Vector2f getPosition() const;
+    b2Vec2 getVelocity() const;
+    float getDirection() const { return m_direction; }
+    // Walking direction (-1 left, 1 right); also sets the body's speed
+    void setDirection(float direction);
+
+    // Savestate: state machine, animation, sprite and body
+    void saveState(StateWriter& writer) const;
+    bool loadState(StateReader& reader);
 
 protected:
     virtual void updateAnimation(float dt) = 0;
     virtual void onStomp() = 0;  // Override for specific stomp behavior
 
+    // Subclass state, stored between the common fields and the body
+    virtual void saveExtra(StateWriter& writer) const {}
+    virtual void loadExtra(StateReader& reader) {}
+    // Puts the saved body back (destroys it if the enemy had none)
+    virtual void restoreBody(const BodyState& body);
+
     Physics& m_physics;
     b2BodyId m_bodyId;
     
-    sf::Texture m_texture;
-    sf::Sprite m_sprite;
+    sf::Sprite m_sprite;  // Texture is owned by TextureCache
     
     State m_state;
     
@@ -3,6 +3,10 @@
 
 #include <SFML/Graphics.hpp>
 #include "Physics.hpp"
+#include "RenderSnapshot.hpp"
+
+class StateWriter;
+class StateReader;
 
 class Fireball {
 public:
@@ -10,18 +14,23 @@ public:
     ~Fireball();
 
     void update(float dt);
-    void draw(sf::RenderWindow& window);
+    void draw(sf::RenderTarget& target);
+    void snapshot(RenderSnapshot& snapshot) const;
     
     bool isAlive() const { return m_alive; }
     sf::FloatRect getBounds() const { return m_sprite.getGlobalBounds(); }
     sf::Vector2f getPosition() const;
     void destroy();
 
+    // Savestate: direction, animation and body
+    void saveState(StateWriter& writer) const;
+    bool loadState(StateReader& reader);
+
 private:
     Physics& m_physics;
     b2BodyId m_bodyId;
     
-    sf::Texture m_texture;
+    const sf::Texture& m_texture; // Owned by TextureCache
     sf::Sprite m_sprite;
     
     float m_animTimer;
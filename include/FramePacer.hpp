@@ -0,0 +1,72 @@
+#ifndef FRAMEPACER_HPP
+#define FRAMEPACER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Frame-time histogram: 0.25 ms bins up to 50 ms, plus an overflow bin
+struct FrameHistogram {
+    static constexpr double BIN_MS = 0.25;
+    static constexpr std::size_t BINS = 200;
+
+    std::array<std::uint32_t, BINS + 1> counts{};
+    std::uint64_t samples = 0;
+    double sumMs = 0.0;
+    double maxMs = 0.0;
+
+    void add(double ms);
+    double mean() const;
+    // Upper edge of the bin holding the p-th fraction of the samples (0..1),
+    // capped at the largest sample
+    double percentile(double p) const;
+};
+
+// Paces the render loop to a fixed rate more precisely than
+// setFramerateLimit (a single coarse sleep that often overshoots): wait()
+// sleeps until shortly before the deadline and spins the rest. Also keeps
+// histograms of the present-to-present interval and of its jitter (the
+// distance from the target period), readable from any thread.
+class FramePacer {
+public:
+    // 0 = uncapped (wait() returns at once; only measures)
+    explicit FramePacer(unsigned int hz = 60);
+
+    void setTargetHz(unsigned int hz);
+    unsigned int targetHz() const;
+
+    // Blocks until the next frame is due. Call before drawing.
+    void wait();
+    // Call right after display()
+    void markPresented();
+
+    struct Stats {
+        unsigned int targetHz;
+        FrameHistogram frameTime; // Present to present
+        FrameHistogram jitter;    // |frame time - target period|
+    };
+    Stats stats() const;
+    void resetStats();
+    // One line per histogram: mean, p50, p99 and max, in ms
+    std::string report() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    // Time left before the deadline where sleeping stops and spinning
+    // starts (covers the scheduler's wake-up latency)
+    static constexpr std::chrono::microseconds SPIN_MARGIN{2000};
+
+    mutable std::mutex m_mutex;
+    unsigned int m_hz;
+    Clock::duration m_period;
+    Clock::time_point m_deadline;
+    Clock::time_point m_lastPresent;
+    bool m_hasPresent = false;
+    FrameHistogram m_frameTime;
+    FrameHistogram m_jitter;
+};
+
+#endif // FRAMEPACER_HPP
@@ -0,0 +1,34 @@
+#ifndef GAMEEVENTS_HPP
+#define GAMEEVENTS_HPP
+
+#include "SpscQueue.hpp"
+#include <cstdint>
+
+// Typed gameplay events pushed by the simulation (Level, Player, main loop).
+// The audio thread consumes them today; telemetry can consume them later.
+enum class GameEventType : std::uint8_t {
+    Stomp,      // Enemy stomped
+    Collect,    // Power-up collected
+    Jump,
+    Damage,     // Player lost a power level
+    Die,
+    Goal,
+    MenuSelect
+};
+
+struct GameEvent {
+    GameEventType type;
+    float x; // World position where it happened (pixels)
+    float y;
+};
+
+using GameEventQueue = SpscQueue<GameEvent, 256>;
+
+// Sessions without a consumer (e.g. tools) pass a null queue
+inline void pushEvent(GameEventQueue* queue, GameEventType type, float x = 0.0f, float y = 0.0f) {
+    if (queue) {
+        queue->push(GameEvent{type, x, y});
+    }
+}
+
+#endif // GAMEEVENTS_HPP
@@ -0,0 +1,85 @@
+#ifndef GAMESESSION_HPP
+#define GAMESESSION_HPP
+
+#include "GameEvents.hpp"
+#include "InputState.hpp"
+#include "InputTrack.hpp"
+#include "Level.hpp"
+#include "Physics.hpp"
+#include "Player.hpp"
+#include "StateHash.hpp"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Encapsulate Game Session to easily reset level.
+// Owns an isolated physics world, so several sessions can coexist.
+struct GameSession {
+  // Fixed simulation tick: every caller steps the session with this dt, so a
+  // run only depends on its per-tick InputState and can be replayed exactly
+  static constexpr float TICK_DT = 1.0f / 60.0f;
+
+  Physics physics;
+  std::unique_ptr<Level> level;
+  std::unique_ptr<Player> player;
+
+  GameSession(float width, float height, int levelNumber = 1,
+              GameEventQueue *events = nullptr);
+  // Generated stress level instead of a numbered one
+  GameSession(float width, float height, const StressLevelSpec &spec,
+              GameEventQueue *events = nullptr);
+
+  // One simulation tick while the level is being played
+  void step(float dt, InputState input);
+  // One tick of the death animation (player keeps falling, world frozen)
+  void stepDeath(float dt, InputState input);
+
+  // Camera center that follows the player, clamped to the level
+  sf::Vector2f cameraCenter() const;
+
+  // Savestate of the whole world into a compact, versioned binary blob.
+  // 'out' is overwritten; reuse it across calls to avoid reallocating.
+  void saveState(std::vector<std::uint8_t> &out) const;
+  // Fails (returning false) on a foreign blob or a different level; a
+  // truncated blob may leave the world partially restored.
+  bool loadState(const std::uint8_t *data, size_t size);
+  bool loadState(const std::vector<std::uint8_t> &blob) {
+    return loadState(blob.data(), blob.size());
+  }
+
+  // Per-subsystem hash of the current state, for determinism checks. Reuses
+  // an internal buffer, so it does not allocate once warmed up.
+  StateHash hashState() const;
+
+  bool isLevelComplete() const { return level->isGoalAnimComplete(); }
+  // Death animation finished: player fell below the screen
+  bool isDeathComplete() const {
+    return player->getPosition().y > m_height + 100.0f;
+  }
+
+private:
+  float m_width;
+  float m_height;
+  mutable std::vector<std::uint8_t> m_hashScratch;
+};
+
+// Unattended play (headless / batch tools): a fresh session driven by a
+// track at the fixed tick until the goal, death or maxTicks
+enum class RunOutcome { Goal, Death, Timeout };
+
+struct RunResult {
+  RunOutcome outcome;
+  unsigned long ticks;
+  float finalX;
+};
+
+// 'record', if given, receives the input actually fed to the session
+RunResult runSession(int levelNumber, const InputTrack &track,
+                     unsigned long maxTicks, InputTrack *record = nullptr);
+// Same, on an existing (fresh) session
+RunResult runSession(GameSession &session, const InputTrack &track,
+                     unsigned long maxTicks, InputTrack *record = nullptr);
+const char *outcomeName(RunOutcome outcome);
+
+#endif // GAMESESSION_HPP
@@ -1,21 +1,68 @@
 #ifndef GAMEWINDOW_HPP
 #define GAMEWINDOW_HPP
 
+#include "FramePacer.hpp"
+#include "InputState.hpp"
+#include "RenderSnapshot.hpp"
+#include "TripleBuffer.hpp"
 #include <SFML/Graphics.hpp>
+#include <atomic>
 #include <functional>
 #include <string>
 
 class GameWindow {
 public:
-    GameWindow(unsigned int width, unsigned int height, const std::string& title);
+    // width x height is the game's fixed resolution: every frame is drawn
+    // into an offscreen target of that size and then scaled to the window
+    // in one pass (by the largest whole factor that fits, letterboxed), so
+    // the window can be resized freely. The window opens 'windowScale'
+    // times larger.
+    GameWindow(unsigned int width, unsigned int height, const std::string& title,
+               unsigned int windowScale = 1);
     ~GameWindow();
 
-    void run(std::function<void(float)> update, std::function<void()> render);
+    // Simulation on the calling thread, drawing on a render thread.
+    // update runs once per fixed tick (GameSession::TICK_DT), as many times
+    // as real time requires; after the ticks, capture fills a snapshot of
+    // the new state, which is handed to the render thread through a triple
+    // buffer. render draws the latest snapshot into the fixed-size target
+    // (already cleared); it runs on the render thread and must only use the
+    // snapshot and objects owned by that thread. Neither side waits for the
+    // other.
+    void run(std::function<void(float)> update,
+             std::function<void(RenderSnapshot&)> capture,
+             std::function<void(const RenderSnapshot&, sf::RenderTarget&)> render);
 
     sf::RenderWindow& window();
 
+    // Render rate: 60, 120, 144... or 0 for uncapped (default 60). With
+    // vsync on, the display paces presents and the pacer only measures.
+    // setVsync touches the GL context: call it before run().
+    void setFrameRate(unsigned int hz);
+    void setVsync(bool enabled);
+    // Frame time / jitter histograms (also printed to stderr with F3)
+    const FramePacer& pacer() const;
+
+    // Samples the keyboard into the player's button mask (once per tick)
+    static InputState sampleInput();
+    // Rewind key (Backspace): not part of InputState, it drives the
+    // RewindBuffer instead of the simulation
+    static bool isRewindHeld();
+
 private:
+    void renderLoop(
+        const std::function<void(const RenderSnapshot&, sf::RenderTarget&)>& render);
+    // Scales m_canvas into the window (render thread)
+    void present();
+
+    sf::Vector2u m_size; // Fixed game resolution
     sf::RenderWindow m_window;
+    sf::RenderTexture m_canvas; // Created by the render thread
+    FramePacer m_pacer;
+    unsigned int m_frameRate = 60;
+    bool m_vsync = false;
+    TripleBuffer<RenderSnapshot> m_snapshots;
+    std::atomic<bool> m_rendering{false};
 };
 
 #endif // GAMEWINDOW_HPP
@@ -1,15 +1,20 @@
 #ifndef GOAL_HPP
 #define GOAL_HPP
 
+#include "RenderSnapshot.hpp"
 #include <SFML/Graphics.hpp>
 
+class StateWriter;
+class StateReader;
+
 class Goal {
 public:
   Goal();
   
   void init(float x, float y);
   void update(float dt);
-  void draw(sf::RenderWindow &window);
+  void draw(sf::RenderTarget &target);
+  void snapshot(RenderSnapshot &snapshot) const;
   
   void trigger(); // Called when Mario reaches the goal
   bool isTriggered() const { return m_triggered; }
@@ -18,8 +23,12 @@ public:
   sf::FloatRect getBounds() const;
   float getX() const { return m_x; }
 
+  // Savestate: trigger and flag animation (position comes from init)
+  void saveState(StateWriter &writer) const;
+  bool loadState(StateReader &reader);
+
 private:
-  sf::Texture m_texture;
+  const sf::Texture &m_texture; // Owned by TextureCache
   sf::Sprite m_sprite;
   
   float m_x;
@@ -0,0 +1,44 @@
+#ifndef HUD_HPP
+#define HUD_HPP
+
+#include <SFML/Graphics.hpp>
+
+// HUD and message screens (lives counter, "Nivel N", "Juego Terminado").
+// The widgets are persistent and the whole layer is rendered once into an
+// offscreen texture (premultiplied alpha), which is then drawn with a
+// single sprite every frame.
+// Text geometry is only rebuilt when the screen or its value changes.
+class Hud {
+public:
+    enum class Screen { None, Playing, Lives, Level, Won };
+
+    // 'size' is the window size in pixels; font and helmet must outlive
+    // the Hud
+    Hud(const sf::Font& font, const sf::Texture& helmet, sf::Vector2u size);
+
+    // Draws 'screen' over the whole target (default view). 'value' is the
+    // number of lives (Playing, Lives) or the level to announce (Level).
+    // Uses the GL context of the calling thread: call it from the thread
+    // that renders.
+    void draw(sf::RenderTarget& target, Screen screen, int value);
+
+private:
+    void rebuild(Screen screen, int value);
+    // Centers 'text' on the screen, 'offsetY' pixels below the middle
+    void centerText(sf::Text& text, float offsetY);
+
+    sf::Vector2u m_size;
+    sf::Text m_livesText;   // Esquina superior (junto al casco)
+    sf::Sprite m_helmet;    // Icono de vidas (esquina)
+    sf::Text m_messageText; // Mensaje centrado
+    sf::Text m_thanksText;  // "Gracias por Jugar"
+    sf::Sprite m_bigHelmet; // Casco junto al mensaje de vidas
+
+    sf::RenderTexture m_cache;
+    sf::Sprite m_cacheSprite;
+    bool m_cacheReady = false;
+    Screen m_screen = Screen::None;
+    int m_value = 0;
+};
+
+#endif // HUD_HPP
@@ -0,0 +1,23 @@
+#ifndef INPUTSTATE_HPP
+#define INPUTSTATE_HPP
+
+#include <cstdint>
+
+// Player buttons for one simulation tick, as a bitmask.
+// Filled from the keyboard by GameWindow, or from a script / replay by the
+// tools, so the game logic itself never reads the keyboard.
+struct InputState {
+    enum Button : std::uint8_t {
+        Left  = 1 << 0,
+        Right = 1 << 1,
+        Down  = 1 << 2,
+        Jump  = 1 << 3,
+        Fire  = 1 << 4
+    };
+
+    std::uint8_t buttons = 0;
+
+    bool held(Button button) const { return (buttons & button) != 0; }
+};
+
+#endif // INPUTSTATE_HPP
@@ -0,0 +1,77 @@
+#ifndef INPUTTRACK_HPP
+#define INPUTTRACK_HPP
+
+#include "InputState.hpp"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Per-tick input of one run (one GameSession), run-length encoded.
+// The simulation advances in fixed ticks and only reads InputState, so
+// feeding a track back reproduces the run exactly: bug reports and perf
+// regressions can be replayed in the game or in the headless runner.
+class InputTrack {
+public:
+    struct Run {
+        std::uint32_t ticks;
+        InputState input;
+    };
+
+    // Starts a new, empty track for the given level
+    void reset(int levelNumber);
+    // Generated levels (Level::STRESS_LEVEL) are stored with their spec
+    // (StressLevelSpec::toString) so a replay can rebuild the same level
+    void setStressSpec(const std::string& spec) { m_stressSpec = spec; }
+    const std::string& stressSpec() const { return m_stressSpec; }
+    // Appends one tick of input
+    void push(InputState input);
+    // Appends 'ticks' ticks of the same input
+    void append(InputState input, std::uint32_t ticks);
+    // Removes the last tick (rewind)
+    void pop();
+
+    int level() const { return m_level; }
+    const std::vector<Run>& runs() const { return m_runs; }
+    unsigned long tickCount() const;
+    bool empty() const { return m_runs.empty(); }
+
+    // Compact binary format: "MRIN", version, level, stress spec (varint
+    // length and text, empty for numbered levels), then one (varint ticks,
+    // button byte) pair per run. Version 1 files (no spec) still load.
+    bool saveToFile(const std::string& path) const;
+    bool loadFromFile(const std::string& path);
+
+    // Hand-written text script, one run per line: "<ticks> <buttons>"
+    // buttons: any of L R D J F (left, right, down, jump, fire), or '-'.
+    // '#' starts a comment. The level is left unchanged.
+    bool loadScript(const std::string& path);
+
+    // Random play for the tools: holds a random button combination for a
+    // random number of ticks, biased to the right so most runs actually
+    // cross the level.
+    static InputTrack randomized(int levelNumber, std::mt19937& rng,
+                                 unsigned long ticks);
+
+private:
+    int m_level = 1;
+    std::string m_stressSpec;
+    std::vector<Run> m_runs;
+};
+
+// Reads a track back one tick at a time
+class InputPlayback {
+public:
+    explicit InputPlayback(const InputTrack& track) : m_track(&track) {}
+
+    // Input for the next tick; no buttons once the track is over
+    InputState next();
+    bool finished() const { return m_run >= m_track->runs().size(); }
+
+private:
+    const InputTrack* m_track;
+    size_t m_run = 0;
+    std::uint32_t m_tick = 0;
+};
+
+#endif // INPUTTRACK_HPP
@@ -1,24 +1,36 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include "Physics.hpp"
+#include "RenderSnapshot.hpp"
+
+class StateWriter;
+class StateReader;
 
 class Item {
 public:
     Item(Physics& physics, float x, float y);
-    virtual ~Item() = default;
+    virtual ~Item();
 
     virtual void update(float dt);
-    virtual void draw(sf::RenderWindow& window);
+    virtual void draw(sf::RenderTarget& target);
+    virtual void snapshot(RenderSnapshot& snapshot) const;
     sf::FloatRect getBounds() const { return m_sprite.getGlobalBounds(); }
 
     bool isCollected() const { return m_collected; }
     bool isSpawning() const { return m_spawning; }
     void collect();
 
+    // Savestate: spawn progress, blink and body
+    void saveState(StateWriter& writer) const;
+    bool loadState(StateReader& reader);
+
 protected:
+    // Dynamic body created once the mushroom has left the block
+    void createBody();
+
     Physics& m_physics;
     b2BodyId m_bodyId;
-    sf::Texture m_texture;
+    const sf::Texture& m_texture; // Owned by TextureCache
     sf::Sprite m_sprite;
     
     bool m_collected;
@@ -20,8 +20,14 @@ public:
 protected:
     void updateAnimation(float dt) override;
     void onStomp() override;
+    void saveExtra(StateWriter& writer) const override;
+    void loadExtra(StateReader& reader) override;
+    void restoreBody(const BodyState& body) override;
 
 private:
+    // Shell knocked off by a fireball: falls through everything
+    void createDyingBody(b2Vec2 position);
+
     KoopaState m_koopaState;
     int m_shellFrame;
     float m_shellAnimTimer;
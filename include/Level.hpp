@@ -5,56 +5,185 @@
 #include "Enemy.hpp"
 #include "FireFlower.hpp"
 #include "Fireball.hpp"
+#include "GameEvents.hpp"
 #include "Goal.hpp"
 #include "Goomba.hpp"
 #include "Item.hpp"
 #include "Koopa.hpp"
+#include "ParallaxBackground.hpp"
+#include "ParticleSystem.hpp"
 #include "Physics.hpp"
-#include <SFML/Audio.hpp>
 #include <SFML/Graphics.hpp>
 #include <box2d/box2d.h>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 
 // Forward declaration
 class Player;
+class StateWriter;
+class StateReader;
+
+// Procedurally generated level for scaling tests: the given number of
+// enemies, platforms, hazards and blocks scattered over a ground of
+// 'width' px. The same spec always generates the same level.
+struct StressLevelSpec {
+  // At least two screens, so the start area and the goal do not overlap
+  static constexpr float MIN_WIDTH = 1600.0f;
+
+  unsigned int seed = 1;
+  float width = 100000.0f;
+  int enemies = 10000;
+  int platforms = 5000;
+  int hazards = 2000;
+  int blocks = 500;
+
+  // "seed[,width[,enemies[,platforms[,hazards[,blocks]]]]]"; missing fields
+  // keep their defaults
+  static bool parse(const std::string &text, StressLevelSpec &spec);
+  // Every field, in the format parse() reads back
+  std::string toString() const;
+};
 
 class Level {
 public:
-  Level(Physics &physics, float width, float height, int levelNumber = 1);
-  void draw(sf::RenderWindow &window);
+  Level(Physics &physics, float width, float height, int levelNumber = 1,
+        GameEventQueue *events = nullptr);
+  // Generated stress level (getLevelNumber() == STRESS_LEVEL)
+  Level(Physics &physics, float width, float height,
+        const StressLevelSpec &spec, GameEventQueue *events = nullptr);
+  static constexpr int STRESS_LEVEL = 0;
+
+  void draw(sf::RenderTarget &target);
+  // Same as draw(), captured for the render thread. Entities are culled to
+  // the snapshot's camera; the static world is referenced as two shared
+  // layers (see StaticLayerCache) instead of being copied.
+  void snapshot(RenderSnapshot &snapshot) const;
   void update(float dt);
   void checkCollisions(Player &player);
 
   // Helper para la cámara
   float groundY() const;
-  float getLevelWidth() const { return LEVEL_WIDTH; }
+  float getLevelWidth() const { return m_levelWidth; }
 
   // Fireballs
   void spawnFireball(float x, float y, float direction);
 
+  // Camera-triggered enemy spawning. Call once per frame with the visible
+  // horizontal range of the camera (world pixels).
+  void updateSpawns(float viewLeft, float viewRight);
+
+  // Observation queries (RL environment, tools). World pixels.
+  enum class Cell : std::uint8_t { Empty = 0, Solid = 1, Block = 2, Hazard = 3 };
+  // Rasterizes the collision geometry into a cols x rows grid (row-major)
+  // whose top-left corner is (left, top). A cell takes the highest Cell
+  // kind overlapping it.
+  void rasterize(float left, float top, float cellSize, int cols, int rows,
+                 std::uint8_t *out) const;
+  // Instantiated enemies (see updateSpawns)
+  const std::vector<std::unique_ptr<Enemy>> &getEnemies() const {
+    return m_enemies;
+  }
+
+  int getLevelNumber() const { return m_levelNumber; }
+
+  // True if 'point' lies inside solid geometry (ground, wall, platform or
+  // block), at least 'margin' px from its edges. Used to detect clipping.
+  bool isInsideSolid(sf::Vector2f point, float margin = 4.0f) const;
+  // Entity bookkeeping (sanity checks in the tools)
+  size_t pendingSpawnCount() const { return m_enemySpawns.size(); }
+  size_t itemCount() const { return m_items.size(); }
+  size_t blockCount() const { return m_blocks.size(); }
+  size_t fireballCount() const { return m_fireballs.size(); }
+
+  // Cosmetic effects: stomps, block hits and fireball kills burst here;
+  // GameSession adds the player's death
+  ParticleSystem &particles() { return m_particles; }
+
+  struct EnemySpawn {
+    enum class Kind { Goomba, Koopa };
+    Kind kind;
+    float x, y;
+    float direction = -1.0f; // Walking direction (-1 left, 1 right)
+  };
+  // Instantiates an enemy right away, bypassing the camera-triggered spawn
+  // list (benchmarks and stress tests)
+  void spawnEnemy(EnemySpawn::Kind kind, float x, float y);
+
+  // Savestate of everything that changes while playing: blocks, items,
+  // enemies (instantiated and pending spawns), fireballs and the goal.
+  // Static geometry is rebuilt by the constructor and not stored.
+  // The blob is the sections below in order; saveSection writes one of
+  // them (the per-tick StateHash hashes them separately).
+  enum class StateSection : std::uint8_t {
+    Blocks,
+    Items,
+    Enemies,
+    Fireballs,
+    Spawns,
+    Goal, // goal and stomp cooldown
+    Count
+  };
+  void saveSection(StateSection section, StateWriter &writer) const;
+  void saveState(StateWriter &writer) const;
+  bool loadState(StateReader &reader);
+
 private:
+  // Shared by both public constructors: ground, walls and, for the numbered
+  // levels, their hand-placed content
+  Level(Physics &physics, float width, float height, int levelNumber,
+        float levelWidth, GameEventQueue *events);
+
+  // Construction helpers (hand-made levels and the stress generator)
+  // Static platform of 32x32 tiles, all using the tilesets.png tile at
+  // 'tile' (16x16 px, drawn at 2x)
+  void addTexturedPlatform(float x, float y, float width, float height,
+                           sf::Vector2f tile);
+  // Trap (trampa.png) standing 'heightBlocks' blocks above the ground
+  void addKillBlock(float x, float heightBlocks);
+  void generateStressContent(const StressLevelSpec &spec);
+  // Captures the static layers on first use (only the game draws them)
+  void buildStaticLayers() const;
+
   Physics &m_physics;
 
   sf::VertexArray m_groundVertices;
   sf::VertexArray m_groundVertices2; // Sección alternativa de suelo
   sf::VertexArray m_groundVertices3; // Tercera sección de suelo desde X=1216
   sf::VertexArray m_groundVertices4; // Cuarta sección de suelo desde X=4800
-  sf::Texture m_texture;
-  sf::Texture m_texture2; // Textura de plataformas.png
+  // Texturas compartidas (TextureCache)
+  const sf::Texture &m_texture;  // tilesets.png
+  const sf::Texture &m_texture2; // Textura de plataformas.png
 
   std::vector<Block> m_blocks;
   std::vector<std::unique_ptr<Item>> m_items;
   std::vector<std::unique_ptr<Enemy>> m_enemies;
   std::vector<std::unique_ptr<Fireball>> m_fireballs;
+  ParticleSystem m_particles;
+
+  // Enemies that are not instantiated yet (or were despawned far behind the
+  // camera). Plain data, kept sorted by x.
+  std::vector<EnemySpawn> m_enemySpawns;
+  void addEnemySpawn(EnemySpawn::Kind kind, float x, float y,
+                     float direction = -1.0f);
+  std::unique_ptr<Enemy> createEnemy(const EnemySpawn &spawn);
+
+  // Spawn slightly before the enemy scrolls into view; despawn well behind
+  // the camera so that short backtracking does not thrash bodies.
+  static constexpr float SPAWN_MARGIN = 64.0f;
+  static constexpr float DESPAWN_DISTANCE = 800.0f;
 
   static constexpr int TILE_SIZE = 16;
-  static constexpr float LEVEL_WIDTH = 6400.0f; // 8 pantallas de ancho
+  static constexpr float DEFAULT_LEVEL_WIDTH = 6400.0f; // 8 pantallas de ancho
 
   b2BodyId m_groundBodyId;
+  // Ground pieces and the left wall, for rasterize()
+  std::vector<sf::FloatRect> m_solidRects;
   float m_width;
   float m_height;
+  float m_levelWidth;
   float m_groundY;
   int m_levelNumber;
 
@@ -84,27 +213,25 @@ private:
   };
   std::vector<KillBlock> m_killBlocks;
 
+  // Ground, decorations, platforms and kill blocks never change after
+  // construction: captured once, in world coordinates
+  mutable std::shared_ptr<const RenderSnapshot> m_staticBack;  // Behind entities
+  mutable std::shared_ptr<const RenderSnapshot> m_staticFront; // In front of entities
+
   // Decoraciones de fondo
-  sf::Texture m_trapTexture;
-  sf::Texture m_bgTexture;   // Nueva textura de fondo
-  sf::Sprite m_bgSprite;     // Nuevo sprite de fondo
+  const sf::Texture &m_trapTexture;
+  const sf::Texture &m_bgTexture; // Nueva textura de fondo
+  ParallaxBackground m_background; // Capas de fondo (una textura repetida)
   sf::Sprite m_cornerSprite; // Sprite "spray" de la esquina
   std::vector<sf::Sprite> m_decorations;
 
   std::vector<sf::RectangleShape> m_coloredPlatforms;
 
-  // Stomp sound effect
-  sf::SoundBuffer m_stompSoundBuffer;
-  sf::Sound m_stompSound;
-
-  // Powerup sound effect
-  sf::SoundBuffer m_powerupSoundBuffer;
-  sf::Sound m_powerupSound;
+  // Gameplay events (stomp, collect, goal) for the audio thread
+  GameEventQueue *m_events;
 
   // Goal
   Goal m_goal;
-  sf::SoundBuffer m_goalSoundBuffer;
-  sf::Sound m_goalSound;
 
 public:
   bool isGoalReached() const { return m_goal.isTriggered(); }
@@ -0,0 +1,87 @@
+#ifndef MUSICMANAGER_HPP
+#define MUSICMANAGER_HPP
+
+#include <SFML/Audio.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Background music: one looping track per level, switched with an
+// equal-power crossfade. The game loop only records what it wants: files
+// are opened and their first half second decoded on a worker thread
+// (prefetch() ahead of time, e.g. during the level screen), and the
+// switch happens inside the audio stream, so no state change waits on
+// disk or on a decoder. Tracks are mixed into one stream at a fixed
+// 44.1 kHz stereo (others are resampled), which makes the fade exact to
+// the sample and keeps loops gapless.
+// A level plays assets/music/nivel<N>.ogg (or .mp3) if it exists, and
+// assets/music/cumbia.MP3 otherwise. Tracks are told apart by that file,
+// so levels sharing one keep it playing across the switch.
+class MusicManager : private sf::SoundStream {
+public:
+    static constexpr unsigned int SAMPLE_RATE = 44100;
+
+    MusicManager();
+    ~MusicManager() override;
+
+    MusicManager(const MusicManager&) = delete;
+    MusicManager& operator=(const MusicManager&) = delete;
+
+    // Starts opening the level's track in the background (no-op if its
+    // file is already open or playing)
+    void prefetch(int level);
+    // Crossfades to the level's track as soon as it is open. The same
+    // file keeps playing where it is instead of restarting.
+    void play(int level, float fadeSeconds = 1.0f);
+    // Fades to silence
+    void stop(float fadeSeconds = 0.5f);
+
+    using sf::SoundStream::setVolume;
+
+private:
+    class Track;
+
+    bool onGetData(Chunk& data) override;
+    void onSeek(sf::Time timeOffset) override;
+
+    void workerLoop();
+    void requestOpen(const std::string& path); // m_mutex held
+    void applyRequest(); // Stream thread, at the start of a chunk
+
+    // Tracks are keyed by file path; an empty path is silence
+    static std::string levelTrackPath(int level);
+
+    // Shared between the game loop, the worker and the stream (m_mutex)
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::string> m_toOpen;
+    std::vector<std::string> m_opening; // Queued or being opened
+    std::map<std::string, std::unique_ptr<Track>> m_ready;
+    std::string m_wanted;
+    float m_wantedFade = 0.0f;
+    bool m_quit = false;
+
+    // Owned by the stream thread; the paths are also read by play() and
+    // prefetch(), so they change under m_mutex
+    std::unique_ptr<Track> m_current;
+    std::unique_ptr<Track> m_next;
+    std::string m_currentPath;
+    std::string m_nextPath;
+    std::uint64_t m_fadeFrames = 0; // Length of the running fade
+    std::uint64_t m_fadeDone = 0;   // Frames of it already mixed
+    std::vector<float> m_mix;
+    std::vector<float> m_gainOut;
+    std::vector<float> m_gainIn;
+    std::vector<std::int16_t> m_output;
+
+    std::thread m_worker; // Declared last: starts after everything else
+};
+
+#endif // MUSICMANAGER_HPP
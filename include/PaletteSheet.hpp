@@ -0,0 +1,56 @@
+#ifndef PALETTESHEET_HPP
+#define PALETTESHEET_HPP
+
+#include <SFML/Graphics.hpp>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Palette-indexed sprite sheet. The source image is split into an index
+// texture with the same layout (each pixel stores the number of its colour
+// in red + green, and its own alpha) and a small palette texture with one
+// band of rows per variant. A fragment shader looks the colour up while
+// drawing, so a recoloured variant (power-up, enemy colours) costs one
+// palette band instead of a second copy of the sheet.
+// Where shaders are not available the variant is recoloured on the CPU
+// once, into a regular texture with the same layout. The index image is
+// only kept on the GPU; that path reads it back when it needs it.
+class PaletteSheet {
+public:
+    // Shared sheet for 'path', built on first use (like TextureCache::get).
+    // In headless mode the sheet is empty and never touches the disk.
+    static PaletteSheet& get(const std::string& path);
+
+    explicit PaletteSheet(const sf::Image& image);
+
+    // Adds a variant whose colours are recolor(original); returns its number
+    // (0 is the original palette). Call before drawing with it.
+    int addVariant(const std::function<sf::Color(sf::Color)>& recolor);
+    int variantCount() const;
+
+    // Texture to give sprites drawn from this sheet
+    const sf::Texture& indexTexture() const { return m_indexTexture; }
+
+    // Fills texture and shader of 'states' to draw the index texture in
+    // 'variant'. Render thread only (creates the shader and the fallback
+    // textures in its GL context).
+    void apply(sf::RenderStates& states, int variant) const;
+    // Draws a sprite whose texture is indexTexture()
+    void draw(sf::RenderTarget& target, const sf::Sprite& sprite, int variant) const;
+
+private:
+    const sf::Texture& fallbackTexture(int variant) const;
+
+    sf::Texture m_indexTexture;
+    unsigned int m_rowsPerVariant = 0;
+    std::vector<sf::Color> m_colors; // Original palette, by index
+    sf::Image m_palette;             // 256 x (rows per variant * variants)
+    sf::Texture m_paletteTexture;
+
+    mutable std::mutex m_fallbackMutex;
+    mutable std::vector<std::unique_ptr<sf::Texture>> m_fallback;
+};
+
+#endif // PALETTESHEET_HPP
@@ -0,0 +1,42 @@
+#ifndef PARALLAXBACKGROUND_HPP
+#define PARALLAXBACKGROUND_HPP
+
+#include "RenderSnapshot.hpp"
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Scrolling background made of layers. Each layer is drawn as a single quad
+// covering the camera view, textured with a repeating texture; scrolling
+// only moves the texture coordinates. The cost is one draw per layer,
+// whatever the width of the level.
+class ParallaxBackground {
+public:
+    // 'texture' must be repeated (see TextureCache::getTiled) and is scaled
+    // to fill [top, top + height) in world y, repeating horizontally.
+    // scrollFactor 1 moves with the world, 0.5 scrolls at half speed
+    // (farther away), 0 stays fixed on screen. Layers draw in insertion
+    // order (back to front).
+    void addLayer(const sf::Texture& texture, float top, float height,
+                  float scrollFactor);
+
+    // Uses the target's current view as the camera
+    void draw(sf::RenderTarget& target) const;
+    // Same quads, for the render thread (uses the snapshot's camera)
+    void snapshot(RenderSnapshot& snapshot) const;
+
+private:
+    struct Layer {
+        const sf::Texture* texture;
+        float top;
+        float height;
+        float scrollFactor;
+    };
+    // Camera-sized quad of 'layer' (TriangleStrip order); false if the
+    // layer is out of view or has no texture
+    bool layerQuad(const Layer& layer, const sf::View& view,
+                   sf::Vertex (&quad)[4]) const;
+
+    std::vector<Layer> m_layers;
+};
+
+#endif // PARALLAXBACKGROUND_HPP
@@ -0,0 +1,62 @@
+#ifndef PARTICLESYSTEM_HPP
+#define PARTICLESYSTEM_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Cosmetic effects (stomp dust, block debris, sparks, death burst).
+// Fixed-capacity pool stored as a struct of arrays: update() is a few
+// straight loops over contiguous floats that the compiler vectorizes, and
+// dead particles are swap-removed so the live ones stay packed at the
+// front. Everything is drawn as one triangle list (6 vertices per
+// particle, untextured). Particles do not affect gameplay and are not part
+// of the savestate.
+class ParticleSystem {
+public:
+    enum class Burst : std::uint8_t {
+        Dust,   // Enemy stomped
+        Debris, // Block hit from below
+        Sparks, // Koopa shell burnt by a fireball
+        Death,  // Player died
+        Count   // Number of bursts, not a burst (rejected by emit/burst)
+    };
+
+    explicit ParticleSystem(std::size_t capacity = 4096);
+
+    // Preset burst at a world position (pixels). Particles that do not fit
+    // in the pool are dropped; returns how many were emitted.
+    std::size_t burst(Burst kind, sf::Vector2f position);
+    // One particle; 'frame' picks the look (colour and size) of a Burst.
+    // False if the pool is full or 'frame' is not a burst.
+    bool emit(sf::Vector2f position, sf::Vector2f velocity, float gravity,
+              float life, Burst frame);
+
+    void update(float dt);
+    void clear();
+
+    std::size_t size() const { return m_count; }
+    std::size_t capacity() const { return m_x.size(); }
+
+    // Triangle list of the live particles, rebuilt when it is stale
+    const sf::VertexArray& vertices() const;
+    void draw(sf::RenderTarget& target) const;
+
+private:
+    std::vector<float> m_x, m_y;   // Position (px)
+    std::vector<float> m_vx, m_vy; // Velocity (px/s)
+    std::vector<float> m_ay;       // Gravity (px/s^2)
+    std::vector<float> m_life;     // Seconds left
+    std::vector<float> m_invLife;  // 1 / initial life (for the fade)
+    std::vector<std::uint8_t> m_frame;
+    std::size_t m_count = 0;
+
+    std::uint32_t m_seed = 0x2545F491u; // Spread of the bursts only
+    float random(float low, float high);
+
+    mutable sf::VertexArray m_vertices;
+    mutable bool m_dirty = true;
+};
+
+#endif // PARTICLESYSTEM_HPP
@@ -0,0 +1,34 @@
+#ifndef PCMASSETS_HPP
+#define PCMASSETS_HPP
+
+#include <SFML/Audio.hpp>
+#include <string>
+#include <vector>
+
+// Short sound effects transcoded to raw 16-bit PCM at build time, so the
+// game never decodes MP3/Vorbis while starting up. tools/transcode_audio.cpp
+// writes them to assets/pcm/; SoundBufferCache maps the file and hands the
+// samples to loadFromSamples, falling back to decoding the source when the
+// cache is missing or stale. Music is not listed: it stays streamed.
+//
+// File layout (little-endian): "MPCM", u16 version, u16 channels,
+// u32 sample rate, u64 sample count (all channels), one u8 sf::SoundChannel
+// per channel, zero padding to a multiple of 8, then the interleaved
+// int16 samples.
+struct PcmAsset {
+    const char* name;   // assets/pcm/<name>.pcm
+    const char* source; // Original file
+
+    std::string path() const;
+
+    // Looks the original file up in all(); nullptr if not cached
+    static const PcmAsset* findSource(const std::string& source);
+    static const std::vector<PcmAsset>& all();
+
+    static bool write(const std::string& path, const sf::SoundBuffer& buffer);
+    // Maps 'path' and copies its samples into 'buffer'. False (and 'buffer'
+    // untouched) if the file is missing or malformed.
+    static bool load(const std::string& path, sf::SoundBuffer& buffer);
+};
+
+#endif // PCMASSETS_HPP
@@ -1,24 +1,39 @@
 #ifndef PLAYER_HPP
 #define PLAYER_HPP
 
+#include "GameEvents.hpp"
+#include "InputState.hpp"
+#include "PaletteSheet.hpp"
 #include "Physics.hpp"
+#include "RenderSnapshot.hpp"
 #include <SFML/Graphics.hpp>
-#include <SFML/Audio.hpp>
+#include <cstdint>
+
+class StateWriter;
+class StateReader;
 
 class Player {
 public:
-  Player(Physics &physics, float startX, float startY);
-  void handleInput(float dt); // Added dt for acceleration timer
-  void update(float dt);
-  void draw(sf::RenderWindow &window);
+  Player(Physics &physics, float startX, float startY,
+         GameEventQueue *events = nullptr);
+  void handleInput(float dt, InputState input); // dt for acceleration timer
+  void update(float dt, InputState input);
+  void draw(sf::RenderTarget &target);
+  void snapshot(RenderSnapshot &snapshot) const;
+  // Sprite frame selection only (called by update; public for the benchmarks)
+  void updateAnimation(float dt);
   void grow();
   void becomeFireMario();
   void bounce(); // Bounce after stomping enemy
   bool isBig() const { return m_isBig; }
   bool isFireMario() const { return m_isFireMario; }
+  // Palette of the current sheet (0 = original, see PaletteSheet::addVariant)
+  void setPaletteVariant(int variant) { m_paletteVariant = variant; }
   // Método helper para la cámara
   sf::Vector2f getPosition() const;
   sf::FloatRect getBounds() const;
+  // Half the physics body's height: getPosition() is the body's centre
+  float getHalfHeight() const;
   b2Vec2 getVelocity() const;
 
   // Damage & Life
@@ -31,19 +46,40 @@ public:
   bool isFrozen() const { return m_frozen; }
 
   // Fireball
-  bool tryShootFireball(); // Returns true if fireball should be spawned
+  bool tryShootFireball(InputState input); // True if a fireball should spawn
   bool isFacingRight() const { return m_facingRight; }
 
+  // Savestate (see StateBuffer.hpp)
+  void saveState(StateWriter &writer) const;
+  bool loadState(StateReader &reader);
+
 private:
-  void updateAnimation(float dt);
+  // Hitbox variants; the body is recreated whenever the shape changes
+  enum class BodyShape : std::uint8_t { Small, Big, Dead };
+  // Replaces the current body (if any) with one of the given shape
+  void createBody(BodyShape shape, b2Vec2 position, b2Vec2 velocity);
+
+  // Body of big Mario, narrower than the sprite (small Mario uses
+  // m_width x m_height)
+  static constexpr float BIG_BODY_WIDTH = 28.0f;
+  static constexpr float BIG_BODY_HEIGHT = 52.0f;
 
   Physics &m_physics;
   b2BodyId m_bodyId;
+  BodyShape m_bodyShape;
 
-  sf::Texture m_texture;
-  sf::Texture m_bigTexture;
-  sf::Texture m_fireTexture;
+  // Palette-indexed sheets (shared, see PaletteSheet::get) and their index
+  // textures, which the sprite uses
+  const PaletteSheet &m_smallSheet;
+  const PaletteSheet &m_bigSheet;
+  const PaletteSheet &m_fireSheet;
+  const sf::Texture &m_texture;
+  const sf::Texture &m_bigTexture;
+  const sf::Texture &m_fireTexture;
   sf::Sprite m_sprite;
+  int m_paletteVariant = 0;
+  // Sheet of the texture the sprite currently shows
+  const PaletteSheet &currentSheet() const;
 
   float m_width;
   float m_height;
@@ -80,13 +116,8 @@ private:
   static constexpr float FIREBALL_COOLDOWN = 0.5f;
   static constexpr float THROW_ANIM_DURATION = 0.15f;
 
-  // Death sound
-  sf::SoundBuffer m_deathSoundBuffer;
-  sf::Sound m_deathSound;
-  
-  // Jump sound
-  sf::SoundBuffer m_jumpSoundBuffer;
-  sf::Sound m_jumpSound;
+  // Gameplay events (jump, damage, death) for the audio thread
+  GameEventQueue *m_events;
 };
 
 #endif // PLAYER_HPP
@@ -0,0 +1,71 @@
+#ifndef RENDERSNAPSHOT_HPP
+#define RENDERSNAPSHOT_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class PaletteSheet;
+class StaticLayerCache;
+
+// Everything needed to draw one frame, captured by the simulation thread
+// after a tick and drawn by the render thread (see GameWindow::run).
+// Sprites and tiles are flattened into textured triangles, grouped into
+// batches of consecutive draws with the same texture, so drawing never
+// touches a game object. Textures come from TextureCache and outlive every
+// snapshot. Objects outside the camera are culled while capturing.
+// Geometry that never changes (a level's static layers) is not copied:
+// it is built once as a RenderSnapshot of its own and referenced.
+struct RenderSnapshot {
+    struct Batch {
+        const sf::Texture* texture; // nullptr = untextured
+        std::size_t first;
+        std::size_t count;
+        int layer = -1; // Index into 'layers' instead of vertices
+        // Index texture drawn through its palette (see PaletteSheet)
+        const PaletteSheet* palette = nullptr;
+        int variant = 0;
+    };
+
+    // World, in camera space
+    sf::View camera;
+    std::vector<sf::Vertex> vertices;
+    std::vector<Batch> batches;
+    std::vector<std::shared_ptr<const RenderSnapshot>> layers;
+
+    // HUD / screen values for the frame (meaning is up to the game loop)
+    int screen = 0;
+    int lives = 0;
+    int level = 0;
+
+    // Empties the world (keeps capacity); set 'camera' before adding
+    void clear();
+
+    // 'palette' = the sprite's texture is that sheet's index texture
+    void addSprite(const sf::Sprite& sprite, const PaletteSheet* palette = nullptr,
+                   int variant = 0);
+    // Fill colour only (texture and outline are ignored)
+    void addRectangle(const sf::RectangleShape& shape);
+    // Triangle list of tiles; only the tiles in view are copied
+    void addTiles(const sf::VertexArray& triangles, const sf::Texture* texture);
+    // Two triangles from a quad given in TriangleStrip order
+    void addQuad(const sf::Vertex (&corners)[4], const sf::Texture* texture,
+                 const PaletteSheet* palette = nullptr, int variant = 0);
+    // Whole pre-built layer, drawn at this point of the batch order
+    void addLayer(std::shared_ptr<const RenderSnapshot> layer);
+
+    // Draws the world with 'camera', its centre rounded to whole pixels
+    // (leaves that view set on the target).
+    // Layers are blitted from 'cache' when given, otherwise drawn directly.
+    void draw(sf::RenderTarget& target, StaticLayerCache* cache = nullptr) const;
+    // Same, with whatever view the target already has
+    void drawBatches(sf::RenderTarget& target, StaticLayerCache* cache = nullptr) const;
+
+private:
+    bool isVisible(const sf::FloatRect& bounds) const;
+    void extendBatch(const sf::Texture* texture, std::size_t count,
+                     const PaletteSheet* palette = nullptr, int variant = 0);
+};
+
+#endif // RENDERSNAPSHOT_HPP
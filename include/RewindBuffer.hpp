@@ -0,0 +1,67 @@
+#ifndef REWINDBUFFER_HPP
+#define REWINDBUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Ring of the last few seconds of savestates (GameSession::saveState), with
+// a hard memory budget allocated once up front.
+//
+// Every KEYFRAME_INTERVAL ticks a keyframe is stored; the ticks in between
+// are stored as the XOR against that keyframe, with runs of zero bytes
+// collapsed (consecutive savestates differ in a few floats, so most of the
+// XOR is zero). When the budget or the frame limit is hit the oldest
+// keyframe is dropped together with the deltas that depend on it.
+class RewindBuffer {
+public:
+    // 8 MB and 600 frames: 10 seconds at 60 Hz
+    explicit RewindBuffer(size_t byteBudget = 8 * 1024 * 1024,
+                          size_t maxFrames = 600, int keyframeInterval = 30);
+
+    // Stores the state reached after one tick
+    void push(const std::vector<std::uint8_t>& state);
+    // Drops the newest frame and decodes the one before it into 'state'
+    // (one tick back). False when there is nothing older to go back to.
+    bool stepBack(std::vector<std::uint8_t>& state);
+    void clear();
+
+    size_t frameCount() const { return m_count; }
+    size_t bytesUsed() const;
+    size_t byteBudget() const { return m_arena.size(); }
+
+private:
+    struct Frame {
+        size_t offset;
+        size_t size;     // Encoded bytes in the arena
+        size_t rawSize;  // Decoded savestate size
+        bool keyframe;
+    };
+
+    // XOR against 'reference' (nullptr = zeros), zero runs collapsed
+    static void encode(const std::vector<std::uint8_t>& state,
+                       const std::uint8_t* reference,
+                       std::vector<std::uint8_t>& out);
+    static void decode(const std::uint8_t* data, size_t size,
+                       std::vector<std::uint8_t>& state);
+
+    Frame& frameAt(size_t index); // 0 = oldest
+    void dropOldestGroup();
+    bool overlapsOldest(size_t offset, size_t size) const;
+    void decodeFrame(size_t index, std::vector<std::uint8_t>& state);
+
+    std::vector<std::uint8_t> m_arena;
+    size_t m_writeOffset = 0;
+
+    std::vector<Frame> m_frames; // Ring, m_first = oldest
+    size_t m_first = 0;
+    size_t m_count = 0;
+
+    int m_keyframeInterval;
+    int m_sinceKeyframe = 0;
+    bool m_forceKeyframe = true;
+    std::vector<std::uint8_t> m_keyframe; // Decoded reference for new deltas
+    std::vector<std::uint8_t> m_scratch;
+};
+
+#endif // REWINDBUFFER_HPP
@@ -0,0 +1,20 @@
+#ifndef SOUNDBUFFERCACHE_HPP
+#define SOUNDBUFFERCACHE_HPP
+
+#include <SFML/Audio.hpp>
+#include <string>
+
+// Load-once decoded sound effects, shared like TextureCache: a file is
+// decoded the first time it is asked for and its PCM stays in memory for
+// the lifetime of the program, whatever creates and destroys sessions.
+// Files listed in PcmAsset::all() are read from their raw PCM cache
+// (make assets) when it is up to date, with no decoding at all.
+class SoundBufferCache {
+public:
+    // Returns the buffer for 'path', decoding it on first use (an empty
+    // buffer if it can't be loaded). The reference stays valid for the
+    // lifetime of the program.
+    static const sf::SoundBuffer& get(const std::string& path);
+};
+
+#endif // SOUNDBUFFERCACHE_HPP
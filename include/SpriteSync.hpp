@@ -0,0 +1,51 @@
+#ifndef SPRITESYNC_HPP
+#define SPRITESYNC_HPP
+
+#include "Physics.hpp"
+#include <SFML/Graphics.hpp>
+
+// Sprite setters that only write when the value actually changes.
+// Every setPosition/setScale invalidates the sprite's cached transform (and
+// a new texture rect rebuilds its vertices), so per-tick code that keeps
+// writing the same value goes through these instead. They return true when
+// the sprite was modified.
+namespace SpriteSync {
+
+inline bool position(sf::Sprite& sprite, sf::Vector2f position) {
+    if (sprite.getPosition() == position) {
+        return false;
+    }
+    sprite.setPosition(position);
+    return true;
+}
+
+inline bool scale(sf::Sprite& sprite, sf::Vector2f scale) {
+    if (sprite.getScale() == scale) {
+        return false;
+    }
+    sprite.setScale(scale);
+    return true;
+}
+
+inline bool textureRect(sf::Sprite& sprite, const sf::IntRect& rect) {
+    if (sprite.getTextureRect() == rect) {
+        return false;
+    }
+    sprite.setTextureRect(rect);
+    return true;
+}
+
+// Moves the sprite to the body's position. A sleeping body cannot have
+// moved since it was last synced, so it is skipped without reading its
+// transform (savestates restore the sprite together with the body).
+inline bool toBody(sf::Sprite& sprite, b2BodyId bodyId) {
+    if (!b2Body_IsValid(bodyId) || !b2Body_IsAwake(bodyId)) {
+        return false;
+    }
+    b2Vec2 pos = b2Body_GetPosition(bodyId);
+    return position(sprite, {pos.x * Physics::SCALE, pos.y * Physics::SCALE});
+}
+
+} // namespace SpriteSync
+
+#endif // SPRITESYNC_HPP
@@ -0,0 +1,91 @@
+#ifndef STATEBUFFER_HPP
+#define STATEBUFFER_HPP
+
+#include <SFML/Graphics.hpp>
+#include <box2d/box2d.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Binary savestate helpers. Values are written field by field in native
+// byte order (no struct padding ends up in the blob), so two identical
+// worlds always produce identical bytes. The blob is meant for the machine
+// that wrote it (rewind, replays, tools), not as a portable file format.
+
+// Box2D body state that changes at runtime. Shapes are not stored: the
+// owning entity recreates the right body before the state is applied.
+struct BodyState {
+    bool valid = false;
+    std::uint8_t type = 0;
+    b2Vec2 position{0.0f, 0.0f};
+    b2Rot rotation{1.0f, 0.0f};
+    b2Vec2 linearVelocity{0.0f, 0.0f};
+    float angularVelocity = 0.0f;
+    bool awake = false;
+    bool enabled = false;
+
+    static BodyState capture(b2BodyId bodyId);
+    // Restores type, transform, velocities and sleep state onto bodyId
+    void apply(b2BodyId bodyId) const;
+};
+
+class StateWriter {
+public:
+    // Appends to 'out' (callers reuse the vector to avoid reallocating)
+    explicit StateWriter(std::vector<std::uint8_t>& out) : m_out(out) {}
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                      "write() takes scalars; compose structs field by field");
+        size_t offset = m_out.size();
+        m_out.resize(offset + sizeof(T));
+        std::memcpy(m_out.data() + offset, &value, sizeof(T));
+    }
+
+    void writeBytes(const void* data, size_t size);
+    void writeBody(b2BodyId bodyId);
+    // Texture rect, origin, position, scale and color (the texture itself
+    // is implied by the owner's state)
+    void writeSprite(const sf::Sprite& sprite);
+
+private:
+    std::vector<std::uint8_t>& m_out;
+};
+
+class StateReader {
+public:
+    StateReader(const std::uint8_t* data, size_t size)
+        : m_data(data), m_size(size) {}
+
+    // Every read fails (and leaves the value untouched) once the blob is
+    // exhausted; check ok() at the end instead of after every field.
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                      "read() takes scalars; compose structs field by field");
+        if (!m_ok || m_size - m_offset < sizeof(T)) {
+            m_ok = false;
+            return false;
+        }
+        std::memcpy(&value, m_data + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return true;
+    }
+
+    bool readBytes(void* data, size_t size);
+    bool readBody(BodyState& body);
+    bool readSprite(sf::Sprite& sprite);
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_offset == m_size; }
+
+private:
+    const std::uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+    bool m_ok = true;
+};
+
+#endif // STATEBUFFER_HPP
@@ -0,0 +1,27 @@
+#ifndef STATEHASH_HPP
+#define STATEHASH_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Fingerprint of a session: one 64-bit FNV-1a hash per subsystem, taken
+// over that subsystem's savestate bytes. Cheap enough to take every tick.
+// Two runs fed the same input (on the same or on different builds) must
+// produce the same sequence; the first differing subsystem tells where
+// determinism broke.
+struct StateHash {
+    // Player first, then the Level::StateSection order
+    enum Subsystem { Player, Blocks, Items, Enemies, Fireballs, Spawns, Goal, Count };
+
+    std::array<std::uint64_t, Count> parts{};
+
+    std::uint64_t combined() const;
+    // First subsystem whose hash differs, or Count if they all match
+    int firstMismatch(const StateHash& other) const;
+
+    static const char* subsystemName(int subsystem);
+    static std::uint64_t fnv1a(const std::uint8_t* data, size_t size);
+};
+
+#endif // STATEHASH_HPP
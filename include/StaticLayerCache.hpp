@@ -0,0 +1,52 @@
+#ifndef STATICLAYERCACHE_HPP
+#define STATICLAYERCACHE_HPP
+
+#include "RenderSnapshot.hpp"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <list>
+#include <memory>
+
+// Pre-rendered tiles of static layers (see Level::staticLayers).
+// The world is cut into a grid of tiles the size of the screen; the first
+// time a tile of a layer becomes visible, the layer is drawn into a
+// RenderTexture once, and from then on each frame draws the (at most four,
+// usually two) visible tiles as sprites. Past 'maxTiles', tiles of layers
+// that no longer exist are recycled first, then the least recently used,
+// so memory stays bounded whatever the level size. Render thread only:
+// the textures belong to its GL context.
+class StaticLayerCache {
+public:
+    // Tiles are drawn over transparency, so they hold premultiplied colour;
+    // this composites them (and any other such offscreen texture)
+    static const sf::BlendMode PREMULTIPLIED;
+
+    StaticLayerCache(sf::Vector2u tileSize, std::size_t maxTiles);
+
+    // Draws the part of 'layer' visible through 'camera' (the target must
+    // already use that view)
+    void draw(sf::RenderTarget& target,
+              const std::shared_ptr<const RenderSnapshot>& layer,
+              const sf::View& camera);
+
+    // Tiles rendered (cache misses) since construction
+    std::size_t renderedTiles() const { return m_rendered; }
+
+private:
+    struct Tile {
+        std::weak_ptr<const RenderSnapshot> layer; // Expired = stale
+        int x;
+        int y;
+        std::unique_ptr<sf::RenderTexture> texture;
+    };
+
+    const sf::Texture* tileTexture(
+        const std::shared_ptr<const RenderSnapshot>& layer, int x, int y);
+
+    sf::Vector2u m_tileSize;
+    std::size_t m_maxTiles;
+    std::list<Tile> m_tiles; // Most recently used first
+    std::size_t m_rendered = 0;
+};
+
+#endif // STATICLAYERCACHE_HPP
@@ -0,0 +1,30 @@
+#ifndef TEXTURECACHE_HPP
+#define TEXTURECACHE_HPP
+
+#include <SFML/Graphics.hpp>
+#include <string>
+
+// Load-once texture storage shared by every entity.
+// Enemies are instantiated while the level is running (camera-triggered
+// spawning), so their constructors must not decode PNGs from disk.
+class TextureCache {
+public:
+    // Returns the texture for 'path', loading it on first use.
+    // The reference stays valid for the lifetime of the program.
+    static const sf::Texture& get(const std::string& path);
+    // Only 'area' of the image, as its own texture with repeating enabled,
+    // so it can tile a quad of any size (ParallaxBackground).
+    static const sf::Texture& getTiled(const std::string& path,
+                                       const sf::IntRect& area);
+    // Pre-scaled sprite strip (see BakedAsset): assets/baked/<name>.png if
+    // it was generated, otherwise baked in memory from the source image.
+    static const sf::Texture& getBaked(const std::string& name);
+
+    // Headless mode: get() hands out an empty texture and never touches the
+    // disk or the GPU. Sprites still carry their texture rects, so bounds
+    // used by the game logic stay correct. Set once, before any lookup.
+    static void setHeadless(bool headless);
+    static bool isHeadless();
+};
+
+#endif // TEXTURECACHE_HPP
@@ -0,0 +1,42 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads pulling jobs from one FIFO queue.
+// Used by the offline tools to run many independent GameSessions at once
+// (each session owns its own physics world, so jobs share nothing).
+class ThreadPool {
+public:
+    // threadCount 0 = one worker per hardware thread
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> job);
+    // Blocks until every submitted job has finished
+    void wait();
+
+    size_t size() const { return m_workers.size(); }
+
+private:
+    void workerLoop();
+
+    std::mutex m_mutex;
+    std::condition_variable m_jobReady;
+    std::condition_variable m_idle;
+    std::deque<std::function<void()>> m_jobs;
+    size_t m_active = 0;
+    bool m_stopping = false;
+    std::vector<std::thread> m_workers;
+};
+
+#endif // THREADPOOL_HPP
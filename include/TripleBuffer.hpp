@@ -0,0 +1,49 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer / single-consumer handoff of the latest value.
+// The producer fills back() and publish()es it; the consumer acquire()s the
+// newest published value and reads front(). Neither side ever waits: the
+// producer may publish several times between two acquires (the older
+// values are simply overwritten) and the consumer keeps reading the same
+// front() until something new arrives. Slots are reused, so T's buffers
+// keep their capacity once warmed up.
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer side
+    T& back() { return m_slots[m_back]; }
+    void publish() {
+        std::uint8_t previous =
+            m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel);
+        m_back = previous & INDEX;
+    }
+
+    // Consumer side. Returns false (front() unchanged) if nothing new was
+    // published since the last call.
+    bool acquire() {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        std::uint8_t previous =
+            m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX;
+        return true;
+    }
+    const T& front() const { return m_slots[m_front]; }
+
+private:
+    static constexpr std::uint8_t INDEX = 3;
+    static constexpr std::uint8_t FRESH = 4;
+
+    T m_slots[3];
+    std::uint8_t m_back = 0;  // Producer only
+    std::uint8_t m_front = 1; // Consumer only
+    // Slot index in between, plus FRESH while it holds an unread value
+    alignas(64) std::atomic<std::uint8_t> m_middle{2};
+};
+
+#endif // TRIPLEBUFFER_HPP
@@ -0,0 +1,41 @@
+#ifndef VOICEPOOL_HPP
+#define VOICEPOOL_HPP
+
+#include <SFML/Audio.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fixed set of sf::Sound voices shared by every sound effect, so the same
+// effect can overlap itself (two stomps in a row) and nothing is allocated
+// while playing. When every voice is busy the new sound steals the voice
+// with the lowest priority, the oldest one among equals, provided it is
+// not more important than the new sound; otherwise the new sound is
+// dropped. Not thread-safe: use it from one thread (AudioSystem's worker).
+class VoicePool {
+public:
+    static constexpr std::size_t DEFAULT_VOICES = 16;
+
+    explicit VoicePool(std::size_t voices = DEFAULT_VOICES);
+
+    VoicePool(const VoicePool&) = delete;
+    VoicePool& operator=(const VoicePool&) = delete;
+
+    // Higher 'priority' wins. Returns false if the sound was dropped.
+    bool play(const sf::SoundBuffer& buffer, int priority, float volume = 100.0f);
+    void stopAll();
+    std::size_t playingCount() const;
+
+private:
+    struct Voice {
+        sf::Sound sound;
+        int priority = 0;
+        std::uint64_t started = 0; // Value of m_plays when it started
+    };
+
+    sf::SoundBuffer m_silence; // Voices need a buffer before their first play
+    std::vector<Voice> m_voices; // Never resized after construction
+    std::uint64_t m_plays = 0;
+};
+
+#endif // VOICEPOOL_HPP
@@ -0,0 +1,107 @@
+/* C API for training agents on the game's levels (libmario_env).
+ *
+ * Each environment wraps one headless GameSession: no window, GPU or audio.
+ * Observations are written straight into a caller-provided MarioObservation,
+ * which may live in shared memory (mario_shm_open), so a local driver (e.g.
+ * Python with ctypes + numpy) reads hundreds of environments without any
+ * copy or serialization. The struct only holds fixed-size POD fields.
+ *
+ * Typical loop:
+ *   MarioObservation *obs = mario_shm_open("/mario", n, 1);
+ *   env[i] = mario_env_create(&obs[i]);
+ *   mario_env_reset(env[i], 1, seed);
+ *   mario_env_step_many(env, actions, n, 4, 0);   // obs[] now updated
+ */
+#ifndef MARIO_ENV_H
+#define MARIO_ENV_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#define MARIO_ENV_API __declspec(dllexport)
+#else
+#define MARIO_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MARIO_ENV_VERSION 1
+
+/* Action bitmask, same bits as InputState */
+#define MARIO_ACTION_LEFT  (1u << 0)
+#define MARIO_ACTION_RIGHT (1u << 1)
+#define MARIO_ACTION_DOWN  (1u << 2)
+#define MARIO_ACTION_JUMP  (1u << 3)
+#define MARIO_ACTION_FIRE  (1u << 4)
+
+/* Occupancy grid around the player, cells of MARIO_OBS_CELL px (one tile).
+ * The player sits in column GRID_W/2 and row GRID_H/2.
+ * Values: 0 empty, 1 solid, 2 question block, 3 hazard (insta-kill). */
+#define MARIO_OBS_GRID_W 24
+#define MARIO_OBS_GRID_H 18
+#define MARIO_OBS_CELL 32.0f
+#define MARIO_OBS_MAX_ENEMIES 16
+
+typedef struct MarioEnemyObs {
+    float dx, dy; /* position relative to the player, px */
+    float vx, vy; /* velocity, px/s */
+    uint8_t kind; /* 0 Goomba, 1 Koopa */
+    uint8_t stomped; /* squashed Goomba or Koopa shell */
+    uint8_t pad[2];
+} MarioEnemyObs;
+
+typedef struct MarioObservation {
+    uint32_t tick; /* ticks since reset */
+    float reward;  /* progress to the right since the previous step, px */
+    uint8_t done;  /* 1 goal, 2 death, 0 still playing */
+    uint8_t big, fire, pad;
+    float x, y;    /* player position, px */
+    float vx, vy;  /* player velocity, px/s */
+    uint32_t enemyCount; /* valid entries in enemies[], nearest first */
+    MarioEnemyObs enemies[MARIO_OBS_MAX_ENEMIES];
+    uint8_t grid[MARIO_OBS_GRID_H][MARIO_OBS_GRID_W];
+} MarioObservation;
+
+typedef struct MarioEnv MarioEnv;
+
+/* 'obs' must stay valid while the environment lives (may be NULL and set
+ * later with mario_env_set_observation). */
+MARIO_ENV_API MarioEnv *mario_env_create(MarioObservation *obs);
+MARIO_ENV_API void mario_env_destroy(MarioEnv *env);
+MARIO_ENV_API void mario_env_set_observation(MarioEnv *env,
+                                             MarioObservation *obs);
+
+/* Starts a fresh session of 'level'. The simulation is deterministic; the
+ * seed only picks a number of idle ticks (0-30) before control is handed
+ * over, so episodes do not all start in lockstep. Returns 0 on success. */
+MARIO_ENV_API int mario_env_reset(MarioEnv *env, int level, uint32_t seed);
+
+/* Holds 'actions' for 'ticks' fixed ticks (stops early when the episode
+ * ends), then writes the observation. Returns obs->done. */
+MARIO_ENV_API int mario_env_step(MarioEnv *env, uint32_t actions,
+                                 uint32_t ticks);
+
+/* Steps count environments in parallel on an internal thread pool
+ * (threads 0 = one per core). actions[i] goes to envs[i]. */
+MARIO_ENV_API void mario_env_step_many(MarioEnv **envs,
+                                       const uint32_t *actions, size_t count,
+                                       uint32_t ticks, uint32_t threads);
+
+MARIO_ENV_API size_t mario_observation_size(void);
+
+/* Named shared memory holding 'count' observations ("/name" on POSIX).
+ * create != 0 creates (and sizes) the segment, otherwise it attaches. */
+MARIO_ENV_API MarioObservation *mario_shm_open(const char *name, size_t count,
+                                               int create);
+MARIO_ENV_API void mario_shm_close(MarioObservation *obs, size_t count);
+/* Removes the name; mappings stay valid until closed */
+MARIO_ENV_API void mario_shm_unlink(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MARIO_ENV_H */
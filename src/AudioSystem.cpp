@@ -0,0 +1,68 @@
+#include "AudioSystem.hpp"
+#include "SoundBufferCache.hpp"
+#include <chrono>
+
+namespace {
+// Who wins a voice when all of them are busy (higher = more important)
+const int PRIORITY_FREQUENT = 0; // Jumps, stomps
+const int PRIORITY_FEEDBACK = 1; // Power-ups, menu
+const int PRIORITY_STORY = 2;    // Damage, death, goal
+} // namespace
+
+AudioSystem::AudioSystem()
+    : m_running(true)
+    , m_stompBuffer(SoundBufferCache::get("assets/music/aplastar.mp3"))
+    , m_powerupBuffer(SoundBufferCache::get("assets/music/powerup.wav"))
+    , m_goalBuffer(SoundBufferCache::get("assets/music/goal_sound.wav"))
+    , m_deathBuffer(SoundBufferCache::get("assets/music/muerte.wav"))
+    , m_jumpBuffer(SoundBufferCache::get("assets/music/jump.ogg"))
+    , m_menuBuffer(SoundBufferCache::get("assets/music/menu_sound.wav"))
+{
+    m_worker = std::thread(&AudioSystem::workerLoop, this);
+}
+
+AudioSystem::~AudioSystem() {
+    m_running = false;
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+void AudioSystem::workerLoop() {
+    GameEvent event;
+    while (m_running) {
+        bool any = false;
+        while (m_events.pop(event)) {
+            handle(event);
+            any = true;
+        }
+        if (!any) {
+            // Nothing queued: yield the core for a moment (well below a frame)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void AudioSystem::handle(const GameEvent& event) {
+    switch (event.type) {
+    case GameEventType::Stomp:
+        m_voices.play(m_stompBuffer, PRIORITY_FREQUENT);
+        break;
+    case GameEventType::Collect:
+        m_voices.play(m_powerupBuffer, PRIORITY_FEEDBACK);
+        break;
+    case GameEventType::Jump:
+        m_voices.play(m_jumpBuffer, PRIORITY_FREQUENT);
+        break;
+    case GameEventType::Damage:
+    case GameEventType::Die:
+        m_voices.play(m_deathBuffer, PRIORITY_STORY);
+        break;
+    case GameEventType::Goal:
+        m_voices.play(m_goalBuffer, PRIORITY_STORY);
+        break;
+    case GameEventType::MenuSelect:
+        m_voices.play(m_menuBuffer, PRIORITY_FEEDBACK);
+        break;
+    }
+}
@@ -0,0 +1,96 @@
+#include "BakedAssets.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+const std::vector<BakedAsset>& BakedAsset::all() {
+    static const std::vector<BakedAsset> assets = {
+        // Bloque trampa: recorte de 434x173 mostrado a 32x32
+        {"trampa", "assets/images/trampa.png",
+         {sf::IntRect({26, 286}, {434, 173})}, {32, 32}},
+        // Bloque de poder: pregunta (frame 0) y vacío (frame 1), 55x42 -> 32x32
+        {"bloques", "assets/images/bloque_poder.png",
+         {sf::IntRect({2, 3}, {55, 42}), sf::IntRect({84, 3}, {55, 42})},
+         {32, 32}},
+    };
+    return assets;
+}
+
+const BakedAsset* BakedAsset::find(const std::string& name) {
+    for (const BakedAsset& asset : all()) {
+        if (name == asset.name) {
+            return &asset;
+        }
+    }
+    return nullptr;
+}
+
+std::string BakedAsset::path() const {
+    return std::string("assets/baked/") + name + ".png";
+}
+
+sf::IntRect BakedAsset::frameRect(int frame) const {
+    return sf::IntRect({frame * static_cast<int>(frameSize.x), 0},
+                       {static_cast<int>(frameSize.x),
+                        static_cast<int>(frameSize.y)});
+}
+
+sf::Image BakedAsset::bake(const sf::Image& source) const {
+    sf::Vector2u size(frameSize.x * static_cast<unsigned int>(frames.size()),
+                      frameSize.y);
+    std::vector<std::uint8_t> pixels(size.x * size.y * 4, 0);
+    const std::uint8_t* src = source.getPixelsPtr();
+    sf::Vector2u srcSize = source.getSize();
+
+    for (std::size_t f = 0; f < frames.size(); ++f) {
+        const sf::IntRect& area = frames[f];
+        float stepX = static_cast<float>(area.size.x) / frameSize.x;
+        float stepY = static_cast<float>(area.size.y) / frameSize.y;
+
+        for (unsigned int dy = 0; dy < frameSize.y; ++dy) {
+            for (unsigned int dx = 0; dx < frameSize.x; ++dx) {
+                // Source footprint of this pixel, weighted by coverage.
+                // Colour is averaged premultiplied by alpha so transparent
+                // pixels don't darken the edges.
+                float x0 = area.position.x + dx * stepX;
+                float y0 = area.position.y + dy * stepY;
+                float x1 = x0 + stepX;
+                float y1 = y0 + stepY;
+                float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+                float weight = 0.0f;
+                for (int sy = static_cast<int>(y0); sy < std::ceil(y1); ++sy) {
+                    float wy = std::min(y1, sy + 1.0f) - std::max(y0, float(sy));
+                    for (int sx = static_cast<int>(x0); sx < std::ceil(x1); ++sx) {
+                        float wx = std::min(x1, sx + 1.0f) - std::max(x0, float(sx));
+                        if (sx < 0 || sy < 0 || sx >= static_cast<int>(srcSize.x) ||
+                            sy >= static_cast<int>(srcSize.y)) {
+                            weight += wx * wy; // Outside the image: transparent
+                            continue;
+                        }
+                        const std::uint8_t* p = src + (sy * srcSize.x + sx) * 4;
+                        float w = wx * wy;
+                        float a = p[3] / 255.0f;
+                        sum[0] += p[0] * a * w;
+                        sum[1] += p[1] * a * w;
+                        sum[2] += p[2] * a * w;
+                        sum[3] += a * w;
+                        weight += w;
+                    }
+                }
+
+                std::uint8_t* out =
+                    &pixels[(dy * size.x + f * frameSize.x + dx) * 4];
+                if (weight <= 0.0f || sum[3] <= 0.0f) {
+                    continue;
+                }
+                for (int c = 0; c < 3; ++c) {
+                    out[c] = static_cast<std::uint8_t>(
+                        std::clamp(sum[c] / sum[3], 0.0f, 255.0f) + 0.5f);
+                }
+                out[3] = static_cast<std::uint8_t>(
+                    std::clamp(sum[3] / weight, 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        }
+    }
+    return sf::Image(size, pixels.data());
+}
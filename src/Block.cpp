@@ -1,25 +1,25 @@
 #include "Block.hpp"
+#include "SpriteSync.hpp"
+#include "StateBuffer.hpp"
+#include "TextureCache.hpp"
 #include <iostream>
 
-Block::Block(Physics &physics, float x, float y)
-    : m_physics(&physics),  m_sprite(m_texture), m_type(Type::Question), m_active(true),
-      m_animTimer(0.0f), m_frame(0) {
-  // Cargar textura primero
-  if (!m_texture.loadFromFile("assets/images/bloque_poder.png")) {
-    std::cerr << "Error loading bloque_poder.png" << std::endl;
-  }
-
-  // Recrear sprite con la textura cargada
-  m_sprite = sf::Sprite(m_texture);
+namespace {
+// Frames of the pre-scaled "bloques" strip (BakedAsset), already 32x32
+const sf::IntRect QUESTION_RECT({0, 0}, {32, 32});
+const sf::IntRect EMPTY_RECT({32, 0}, {32, 32});
+} // namespace
 
+Block::Block(Physics &physics, float x, float y)
+    : m_physics(&physics),
+      m_sprite(TextureCache::getBaked("bloques")),
+      m_type(Type::Question), m_active(true), m_animTimer(0.0f), m_frame(0) {
   // Sprite del bloque - Estado inicial (Question)
-  // Usuario especificó: empieza en (2,3) y es de 55x42
-  m_sprite.setTextureRect(sf::IntRect({2, 3}, {55, 42}));
-  m_sprite.setOrigin({27.5f, 21.0f}); // Center (55/2, 42/2)
-  
-  // Escalar para que sea exactamente de 32x32 (tamaño de la cuadrícula)
-  m_sprite.setScale({32.0f / 55.0f, 32.0f / 42.0f}); 
-  
+  // Recorte (2,3) de 55x42 de bloque_poder.png, ya reducido a 32x32 (el
+  // tamaño de la cuadrícula), así que se dibuja sin escalar
+  m_sprite.setTextureRect(QUESTION_RECT);
+  m_sprite.setOrigin({16.0f, 16.0f}); // Center
+
   m_sprite.setPosition({x, y});
 
   // Physics Body (Static)
@@ -42,16 +42,11 @@ Block::Block(Physics &physics, float x, float y)
 Block::Block(Block&& other) noexcept
     : m_physics(other.m_physics),
       m_bodyId(other.m_bodyId),
-      m_texture(std::move(other.m_texture)), 
       m_sprite(std::move(other.m_sprite)),
       m_type(other.m_type),
       m_active(other.m_active),
       m_animTimer(other.m_animTimer),
       m_frame(other.m_frame) {
-  
-  // Re-link sprite to the new texture location in memory
-  m_sprite.setTexture(m_texture);
-  
   other.m_bodyId = b2_nullBodyId; 
   other.m_physics = nullptr;
 }
@@ -61,16 +56,12 @@ Block& Block::operator=(Block&& other) noexcept {
   if (this != &other) {
     m_physics = other.m_physics;
     m_bodyId = other.m_bodyId;
-    m_texture = std::move(other.m_texture);
     m_sprite = std::move(other.m_sprite);
     m_type = other.m_type;
     m_active = other.m_active;
     m_animTimer = other.m_animTimer;
     m_frame = other.m_frame;
 
-    // Re-link sprite
-    m_sprite.setTexture(m_texture);
-
     other.m_bodyId = b2_nullBodyId;
     other.m_physics = nullptr;
   }
@@ -79,25 +70,49 @@ Block& Block::operator=(Block&& other) noexcept {
 
 void Block::update(float dt) {
   // Animación removida temporalmente ya que el usuario especificó solo dos estados estáticos
+  // (solo escribe si el recorte cambió; el sprite ya lo tiene casi siempre)
   if (m_type == Type::Question) {
-     m_sprite.setTextureRect(sf::IntRect({2, 3}, {55, 42}));
+    SpriteSync::textureRect(m_sprite, QUESTION_RECT);
   }
 }
 
 bool Block::hit() {
   if (m_type == Type::Question) {
     m_type = Type::Empty;
-    // Cambiar a bloque vacío (segundo sprite)
-    // Usuario pidió mover el recorte a la derecha. 
-    // Anterior: 59. Ajustando a 84 (aprox +25px).
-    m_sprite.setTextureRect(sf::IntRect({84, 3}, {55, 42}));
+    // Cambiar a bloque vacío (segundo sprite: recorte (84,3) del original)
+    m_sprite.setTextureRect(EMPTY_RECT);
     return true; // First hit - spawn item
   }
   return false; // Already hit - no item
 }
 
-void Block::draw(sf::RenderWindow &window) { window.draw(m_sprite); }
+void Block::draw(sf::RenderTarget &target) { target.draw(m_sprite); }
+
+void Block::snapshot(RenderSnapshot &snapshot) const {
+  snapshot.addSprite(m_sprite);
+}
 
 sf::FloatRect Block::getBounds() const { return m_sprite.getGlobalBounds(); }
 
 sf::Vector2f Block::getPosition() const { return m_sprite.getPosition(); }
+
+void Block::saveState(StateWriter &writer) const {
+  writer.write(m_type);
+  writer.write<std::uint8_t>(m_active);
+  writer.write(m_animTimer);
+  writer.write<std::int32_t>(m_frame);
+  writer.writeSprite(m_sprite);
+}
+
+bool Block::loadState(StateReader &reader) {
+  std::uint8_t active = 0;
+  std::int32_t frame = 0;
+  reader.read(m_type);
+  reader.read(active);
+  reader.read(m_animTimer);
+  reader.read(frame);
+  reader.readSprite(m_sprite);
+  m_active = active;
+  m_frame = frame;
+  return reader.ok();
+}
@@ -1,10 +1,13 @@
 #include "Enemy.hpp"
+#include "SpriteSync.hpp"
+#include "StateBuffer.hpp"
 #include <iostream>
 #include <cmath>
 
-Enemy::Enemy(Physics& physics, float x, float y)
+Enemy::Enemy(Physics& physics, const sf::Texture& texture, float x, float y)
     : m_physics(physics)
-    , m_sprite(m_texture)
+    , m_bodyId(b2_nullBodyId)
+    , m_sprite(texture)
     , m_state(State::Walking)
     , m_animationTimer(0.0f)
     , m_currentFrame(0)
@@ -41,15 +44,11 @@ void Enemy::update(float dt) {
     
     // Sync sprite with physics
     if (b2Body_IsValid(m_bodyId)) {
-        b2Vec2 pos = b2Body_GetPosition(m_bodyId);
-        m_sprite.setPosition({pos.x * Physics::SCALE, pos.y * Physics::SCALE});
+        SpriteSync::toBody(m_sprite, m_bodyId);
         
-        // Flip sprite based on direction
-        if (m_direction > 0) {
-            m_sprite.setScale({-2.0f, 2.0f});  // Facing right (mirrored)
-        } else {
-            m_sprite.setScale({2.0f, 2.0f});   // Facing left (normal)
-        }
+        // Flip sprite based on direction: mirrored when facing right
+        // (only written when the direction changes)
+        SpriteSync::scale(m_sprite, {m_direction > 0 ? -2.0f : 2.0f, 2.0f});
         
         // Maintain horizontal velocity
         b2Vec2 vel = b2Body_GetLinearVelocity(m_bodyId);
@@ -64,9 +63,15 @@ void Enemy::update(float dt) {
     }
 }
 
-void Enemy::draw(sf::RenderWindow& window) {
+void Enemy::draw(sf::RenderTarget& target) {
     if (m_state != State::Dead) {
-        window.draw(m_sprite);
+        target.draw(m_sprite);
+    }
+}
+
+void Enemy::snapshot(RenderSnapshot& snapshot) const {
+    if (m_state != State::Dead) {
+        snapshot.addSprite(m_sprite);
     }
 }
 
@@ -95,3 +100,59 @@ sf::Vector2f Enemy::getPosition() const {
     }
     return m_sprite.getPosition();
 }
+
+void Enemy::setDirection(float direction) {
+    m_direction = direction;
+    if (m_state == State::Walking && b2Body_IsValid(m_bodyId)) {
+        b2Vec2 vel = b2Body_GetLinearVelocity(m_bodyId);
+        b2Body_SetLinearVelocity(m_bodyId, (b2Vec2){WALK_SPEED * m_direction, vel.y});
+    }
+}
+
+b2Vec2 Enemy::getVelocity() const {
+    if (b2Body_IsValid(m_bodyId)) {
+        return b2Body_GetLinearVelocity(m_bodyId);
+    }
+    return {0.0f, 0.0f};
+}
+
+void Enemy::saveState(StateWriter& writer) const {
+    writer.write(m_state);
+    writer.write(m_animationTimer);
+    writer.write<std::int32_t>(m_currentFrame);
+    writer.write(m_direction);
+    writer.write(m_stompTimer);
+    saveExtra(writer);
+    writer.writeSprite(m_sprite);
+    writer.writeBody(m_bodyId);
+}
+
+bool Enemy::loadState(StateReader& reader) {
+    std::int32_t currentFrame = 0;
+    reader.read(m_state);
+    reader.read(m_animationTimer);
+    reader.read(currentFrame);
+    reader.read(m_direction);
+    reader.read(m_stompTimer);
+    loadExtra(reader);
+    reader.readSprite(m_sprite);
+    BodyState body;
+    reader.readBody(body);
+    if (!reader.ok()) {
+        return false;
+    }
+    m_currentFrame = currentFrame;
+    restoreBody(body);
+    return true;
+}
+
+void Enemy::restoreBody(const BodyState& body) {
+    if (!body.valid) {
+        if (b2Body_IsValid(m_bodyId)) {
+            b2DestroyBody(m_bodyId);
+            m_bodyId = b2_nullBodyId;
+        }
+        return;
+    }
+    body.apply(m_bodyId);
+}
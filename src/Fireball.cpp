@@ -1,9 +1,13 @@
 #include "Fireball.hpp"
+#include "SpriteSync.hpp"
+#include "StateBuffer.hpp"
+#include "TextureCache.hpp"
 #include <iostream>
 #include <cmath>
 
 Fireball::Fireball(Physics& physics, float x, float y, float direction)
     : m_physics(physics)
+    , m_texture(TextureCache::get("assets/images/items.png"))
     , m_sprite(m_texture)
     , m_animTimer(0.0f)
     , m_frame(0)
@@ -11,12 +15,6 @@ Fireball::Fireball(Physics& physics, float x, float y, float direction)
     , m_direction(direction)
     , m_bounceCount(0)
 {
-    // Load texture
-    if (!m_texture.loadFromFile("assets/images/items.png")) {
-        std::cerr << "Error loading items.png for Fireball" << std::endl;
-    }
-    m_sprite.setTexture(m_texture);
-    
     // Set initial frame
     m_sprite.setTextureRect(sf::IntRect({FRAME_POSITIONS[0][0], FRAME_POSITIONS[0][1]}, {SPRITE_SIZE, SPRITE_SIZE}));
     m_sprite.setOrigin({SPRITE_SIZE / 2.0f, SPRITE_SIZE / 2.0f});
@@ -66,21 +64,28 @@ void Fireball::update(float dt) {
     if (b2Body_IsValid(m_bodyId)) {
         b2Vec2 pos = b2Body_GetPosition(m_bodyId);
         
-        m_sprite.setPosition({pos.x * Physics::SCALE, pos.y * Physics::SCALE});
+        SpriteSync::position(m_sprite, {pos.x * Physics::SCALE, pos.y * Physics::SCALE});
         
         // Keep constant horizontal velocity (straight line)
         b2Body_SetLinearVelocity(m_bodyId, (b2Vec2){SPEED * m_direction, 0.0f});
         
-        // Destroy if out of bounds (LEVEL_WIDTH = 6400, plus margin)
-        if (pos.x * Physics::SCALE < -100.0f || pos.x * Physics::SCALE > 6600.0f) {
+        // Destroy if out of bounds (the right edge depends on the level
+        // width and is checked by Level::update)
+        if (pos.x * Physics::SCALE < -100.0f) {
             destroy();
         }
     }
 }
 
-void Fireball::draw(sf::RenderWindow& window) {
+void Fireball::draw(sf::RenderTarget& target) {
     if (m_alive) {
-        window.draw(m_sprite);
+        target.draw(m_sprite);
+    }
+}
+
+void Fireball::snapshot(RenderSnapshot& snapshot) const {
+    if (m_alive) {
+        snapshot.addSprite(m_sprite);
     }
 }
 
@@ -99,3 +104,38 @@ void Fireball::destroy() {
         m_bodyId = b2_nullBodyId;
     }
 }
+
+void Fireball::saveState(StateWriter& writer) const {
+    writer.write(m_direction);
+    writer.write(m_animTimer);
+    writer.write<std::int32_t>(m_frame);
+    writer.write<std::int32_t>(m_bounceCount);
+    writer.write<std::uint8_t>(m_alive);
+    writer.writeSprite(m_sprite);
+    writer.writeBody(m_bodyId);
+}
+
+bool Fireball::loadState(StateReader& reader) {
+    std::int32_t frame = 0, bounceCount = 0;
+    std::uint8_t alive = 0;
+    reader.read(m_direction);
+    reader.read(m_animTimer);
+    reader.read(frame);
+    reader.read(bounceCount);
+    reader.read(alive);
+    reader.readSprite(m_sprite);
+    BodyState body;
+    reader.readBody(body);
+    if (!reader.ok()) {
+        return false;
+    }
+    m_frame = frame;
+    m_bounceCount = bounceCount;
+
+    if (!alive || !body.valid) {
+        destroy();
+    } else {
+        body.apply(m_bodyId);
+    }
+    return true;
+}
@@ -0,0 +1,120 @@
+#include "FramePacer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <thread>
+
+void FrameHistogram::add(double ms) {
+    std::size_t bin = std::min(BINS, static_cast<std::size_t>(std::max(0.0, ms) / BIN_MS));
+    ++counts[bin];
+    ++samples;
+    sumMs += ms;
+    maxMs = std::max(maxMs, ms);
+}
+
+double FrameHistogram::mean() const {
+    return samples ? sumMs / samples : 0.0;
+}
+
+double FrameHistogram::percentile(double p) const {
+    if (samples == 0) {
+        return 0.0;
+    }
+    std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(p * samples));
+    std::uint64_t seen = 0;
+    for (std::size_t bin = 0; bin < BINS; ++bin) {
+        seen += counts[bin];
+        if (seen >= rank) {
+            return std::min((bin + 1) * BIN_MS, maxMs);
+        }
+    }
+    return maxMs; // In the overflow bin
+}
+
+FramePacer::FramePacer(unsigned int hz) {
+    setTargetHz(hz);
+}
+
+void FramePacer::setTargetHz(unsigned int hz) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_hz = hz;
+    m_period = hz ? std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double>(1.0 / hz))
+                  : Clock::duration::zero();
+    m_deadline = Clock::now();
+}
+
+unsigned int FramePacer::targetHz() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hz;
+}
+
+void FramePacer::wait() {
+    Clock::time_point deadline;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_hz == 0) {
+            return;
+        }
+        // Deadlines advance by whole periods so errors don't accumulate;
+        // after a stall longer than a frame, start again from now instead
+        // of rushing the missed frames out
+        Clock::time_point now = Clock::now();
+        m_deadline += m_period;
+        if (m_deadline < now - m_period) {
+            m_deadline = now;
+        }
+        deadline = m_deadline;
+    }
+
+    if (deadline - Clock::now() > SPIN_MARGIN) {
+        std::this_thread::sleep_until(deadline - SPIN_MARGIN);
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::markPresented() {
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_hasPresent) {
+        double ms = std::chrono::duration<double, std::milli>(now - m_lastPresent).count();
+        double periodMs = std::chrono::duration<double, std::milli>(m_period).count();
+        m_frameTime.add(ms);
+        if (m_hz != 0) {
+            m_jitter.add(std::abs(ms - periodMs));
+        }
+    }
+    m_lastPresent = now;
+    m_hasPresent = true;
+}
+
+FramePacer::Stats FramePacer::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return {m_hz, m_frameTime, m_jitter};
+}
+
+void FramePacer::resetStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frameTime = FrameHistogram();
+    m_jitter = FrameHistogram();
+    m_hasPresent = false;
+}
+
+std::string FramePacer::report() const {
+    Stats s = stats();
+    std::ostringstream out;
+    out << "target " << (s.targetHz ? std::to_string(s.targetHz) + " Hz" : "uncapped")
+        << ", " << s.frameTime.samples << " frames\n";
+    auto line = [&out](const char* name, const FrameHistogram& h) {
+        out << "  " << name << ": mean " << h.mean() << " ms, p50 "
+            << h.percentile(0.5) << " ms, p99 " << h.percentile(0.99)
+            << " ms, max " << h.maxMs << " ms\n";
+    };
+    line("frame time", s.frameTime);
+    if (s.targetHz) {
+        line("jitter    ", s.jitter);
+    }
+    return out.str();
+}
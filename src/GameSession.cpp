@@ -0,0 +1,178 @@
+#include "GameSession.hpp"
+#include "StateBuffer.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+const std::uint32_t STATE_MAGIC = 0x5453524D; // "MRST"
+const std::uint16_t STATE_VERSION = 4;
+} // namespace
+
+GameSession::GameSession(float width, float height, int levelNumber,
+                         GameEventQueue *events)
+    : m_width(width), m_height(height) {
+  level = std::make_unique<Level>(physics, width, height, levelNumber, events);
+  player = std::make_unique<Player>(physics, 100.0f, 400.0f, events);
+}
+
+GameSession::GameSession(float width, float height,
+                         const StressLevelSpec &spec, GameEventQueue *events)
+    : m_width(width), m_height(height) {
+  level = std::make_unique<Level>(physics, width, height, spec, events);
+  player = std::make_unique<Player>(physics, 100.0f, 400.0f, events);
+}
+
+void GameSession::step(float dt, InputState input) {
+  bool wasDead = player->isDead();
+  physics.step(dt);
+  player->handleInput(dt, input);
+  player->update(dt, input);
+  level->update(dt);
+  level->checkCollisions(*player);
+
+  // Check if player wants to shoot fireball
+  if (player->tryShootFireball(input)) {
+    float dir = player->isFacingRight() ? 1.0f : -1.0f;
+    sf::Vector2f pos = player->getPosition();
+    // Spawn fireball slightly in front of Mario
+    level->spawnFireball(pos.x + dir * 20.0f, pos.y - 10.0f, dir);
+  }
+
+  // Instantiate / retire enemies around the visible area
+  float camX = cameraCenter().x;
+  level->updateSpawns(camX - m_width / 2.0f, camX + m_width / 2.0f);
+
+  // Freeze player when goal is reached
+  if (level->isGoalReached()) {
+    player->freeze();
+  }
+
+  // Fell into void
+  if (!player->isDead() && player->getPosition().y > m_height + 50.0f) {
+    player->die();
+  }
+
+  // Player::die() is reached from several places (collisions, falls):
+  // burst once, on the tick it happened
+  if (!wasDead && player->isDead()) {
+    level->particles().burst(ParticleSystem::Burst::Death,
+                             player->getPosition());
+  }
+}
+
+void GameSession::stepDeath(float dt, InputState input) {
+  // Continue physics for destruction/falling
+  physics.step(dt);
+  player->update(dt, input);
+  level->particles().update(dt);
+}
+
+void GameSession::saveState(std::vector<std::uint8_t> &out) const {
+  out.clear();
+  StateWriter writer(out);
+  writer.write(STATE_MAGIC);
+  writer.write(STATE_VERSION);
+  writer.write<std::uint16_t>(static_cast<std::uint16_t>(level->getLevelNumber()));
+  level->saveState(writer);
+  player->saveState(writer);
+}
+
+bool GameSession::loadState(const std::uint8_t *data, size_t size) {
+  StateReader reader(data, size);
+  std::uint32_t magic = 0;
+  std::uint16_t version = 0;
+  std::uint16_t levelNumber = 0;
+  reader.read(magic);
+  reader.read(version);
+  reader.read(levelNumber);
+  if (!reader.ok() || magic != STATE_MAGIC || version != STATE_VERSION) {
+    std::cerr << "Error loading state: not a savestate (or an old version)"
+              << std::endl;
+    return false;
+  }
+  if (levelNumber != level->getLevelNumber()) {
+    std::cerr << "Error loading state: saved on level " << levelNumber
+              << ", session plays level " << level->getLevelNumber()
+              << std::endl;
+    return false;
+  }
+
+  bool loaded = level->loadState(reader) && player->loadState(reader);
+  if (!loaded || !reader.atEnd()) {
+    std::cerr << "Error loading state: truncated or corrupt" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+StateHash GameSession::hashState() const {
+  StateHash hash;
+  StateWriter writer(m_hashScratch);
+  m_hashScratch.clear();
+  player->saveState(writer);
+  hash.parts[StateHash::Player] =
+      StateHash::fnv1a(m_hashScratch.data(), m_hashScratch.size());
+
+  for (int section = 0; section < static_cast<int>(Level::StateSection::Count);
+       ++section) {
+    m_hashScratch.clear();
+    level->saveSection(static_cast<Level::StateSection>(section), writer);
+    hash.parts[StateHash::Blocks + section] =
+        StateHash::fnv1a(m_hashScratch.data(), m_hashScratch.size());
+  }
+  return hash;
+}
+
+sf::Vector2f GameSession::cameraCenter() const {
+  // Camera Follow with Constraints
+  // Block left movement (minCamX)
+  float minCamX = m_width / 2.0f;
+  // Block right movement (maxCamX) - usar el ancho del nivel
+  float maxCamX = level->getLevelWidth() - m_width / 2.0f;
+  float camX = std::max(player->getPosition().x, minCamX);
+  camX = std::min(camX, maxCamX); // Limitar al borde derecho
+
+  // Block down movement (maxCamY) - Ground is at bottom
+  float maxCamY = m_height / 2.0f;
+  float camY = std::min(player->getPosition().y, maxCamY);
+
+  return {camX, camY};
+}
+
+RunResult runSession(int levelNumber, const InputTrack &track,
+                     unsigned long maxTicks, InputTrack *record) {
+  // Same view size as the game window: spawning follows the camera
+  GameSession session(800.0f, 600.0f, levelNumber);
+  return runSession(session, track, maxTicks, record);
+}
+
+RunResult runSession(GameSession &session, const InputTrack &track,
+                     unsigned long maxTicks, InputTrack *record) {
+  InputPlayback playback(track);
+
+  for (unsigned long tick = 0; tick < maxTicks; ++tick) {
+    InputState input = playback.next();
+    if (record) {
+      record->push(input);
+    }
+
+    session.step(GameSession::TICK_DT, input);
+
+    if (session.player->isDead()) {
+      return {RunOutcome::Death, tick + 1, session.player->getPosition().x};
+    }
+    if (session.isLevelComplete()) {
+      return {RunOutcome::Goal, tick + 1, session.player->getPosition().x};
+    }
+  }
+  return {RunOutcome::Timeout, maxTicks, session.player->getPosition().x};
+}
+
+const char *outcomeName(RunOutcome outcome) {
+  switch (outcome) {
+  case RunOutcome::Goal: return "goal";
+  case RunOutcome::Death: return "death";
+  case RunOutcome::Timeout: return "timeout";
+  }
+  return "?";
+}
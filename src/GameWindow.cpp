@@ -1,36 +1,172 @@
 #include "GameWindow.hpp"
+#include "GameSession.hpp"
 #include <SFML/Window/Event.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
 
-GameWindow::GameWindow(unsigned int width, unsigned int height, const std::string& title)
-: m_window(sf::VideoMode({width, height}), title)
+GameWindow::GameWindow(unsigned int width, unsigned int height, const std::string& title,
+                       unsigned int windowScale)
+: m_size(width, height),
+  m_window(sf::VideoMode({width * std::max(1u, windowScale),
+                          height * std::max(1u, windowScale)}), title),
+  m_pacer(60)
 {
-    m_window.setFramerateLimit(60);
 }
 
 GameWindow::~GameWindow() {}
 
-void GameWindow::run(std::function<void(float)> update, std::function<void()> render)
+void GameWindow::run(std::function<void(float)> update,
+                     std::function<void(RenderSnapshot&)> capture,
+                     std::function<void(const RenderSnapshot&, sf::RenderTarget&)> render)
 {
+    // Longest frame the simulation catches up on (avoids a spiral of death
+    // after a stall, e.g. while the window is being dragged)
+    const float MAX_FRAME_TIME = 0.25f;
+
+    // The render thread owns the GL context from now on; events are still
+    // polled here (they must come from the thread that created the window)
+    capture(m_snapshots.back());
+    m_snapshots.publish();
+    if (!m_window.setActive(false)) {
+        std::cerr << "Error releasing the window's GL context" << std::endl;
+    }
+    m_rendering = true;
+    std::thread renderThread(&GameWindow::renderLoop, this, std::cref(render));
+
     sf::Clock clock;
-    while (m_window.isOpen()) {
+    float accumulator = 0.0f;
+    bool open = true;
+    while (open) {
         while (const std::optional event = m_window.pollEvent()) {
             if (event->is<sf::Event::Closed>()) {
-                m_window.close();
+                open = false;
+            } else if (const auto* key = event->getIf<sf::Event::KeyPressed>()) {
+                if (key->code == sf::Keyboard::Key::F3) {
+                    std::cerr << m_pacer.report();
+                }
             }
         }
 
-        float dt = clock.restart().asSeconds();
+        // Fixed timestep: the game always advances in whole ticks
+        accumulator += std::min(clock.restart().asSeconds(), MAX_FRAME_TIME);
+        bool ticked = false;
+        while (accumulator >= GameSession::TICK_DT) {
+            update(GameSession::TICK_DT);
+            accumulator -= GameSession::TICK_DT;
+            ticked = true;
+        }
 
-        update(dt);
+        if (ticked) {
+            capture(m_snapshots.back());
+            m_snapshots.publish();
+        } else {
+            // Nothing to do until the next tick is due
+            std::this_thread::sleep_for(std::chrono::duration<float>(
+                GameSession::TICK_DT - accumulator));
+        }
+    }
+
+    m_rendering = false;
+    renderThread.join();
+    m_window.close();
+}
 
-        m_window.clear(sf::Color(100, 149, 237));
-        render();
-        m_window.display();
+void GameWindow::renderLoop(
+    const std::function<void(const RenderSnapshot&, sf::RenderTarget&)>& render)
+{
+    if (!m_window.setActive(true)) {
+        std::cerr << "Error activating the window on the render thread" << std::endl;
+        return;
     }
+    if (!m_canvas.resize(m_size)) {
+        std::cerr << "Error creating the offscreen render target" << std::endl;
+        return;
+    }
+    m_canvas.setSmooth(false); // Whole-pixel upscaling stays sharp
+
+    while (m_rendering) {
+        // One present per paced frame, with the newest snapshot (the last
+        // one again if the simulation hasn't ticked since)
+        m_pacer.wait();
+        m_snapshots.acquire();
+        m_canvas.clear(sf::Color(100, 149, 237));
+        render(m_snapshots.front(), m_canvas);
+        m_canvas.display();
+        present();
+        m_pacer.markPresented();
+    }
+    static_cast<void>(m_window.setActive(false));
+}
+
+void GameWindow::present()
+{
+    sf::Vector2u windowSize = m_window.getSize();
+    float scale = std::min(static_cast<float>(windowSize.x) / m_size.x,
+                           static_cast<float>(windowSize.y) / m_size.y);
+    // Whole factors only, unless the window is smaller than the game
+    if (scale >= 1.0f) {
+        scale = std::floor(scale);
+    }
+
+    sf::Sprite canvas(m_canvas.getTexture());
+    canvas.setScale({scale, scale});
+    canvas.setPosition({std::floor((windowSize.x - m_size.x * scale) / 2.0f),
+                        std::floor((windowSize.y - m_size.y * scale) / 2.0f)});
+
+    m_window.setView(sf::View(sf::FloatRect(
+        {0.0f, 0.0f},
+        {static_cast<float>(windowSize.x), static_cast<float>(windowSize.y)})));
+    m_window.clear(sf::Color::Black); // Letterbox
+    m_window.draw(canvas);
+    m_window.display();
+}
+
+InputState GameWindow::sampleInput()
+{
+    using Key = sf::Keyboard::Key;
+    InputState input;
+    if (sf::Keyboard::isKeyPressed(Key::Left) || sf::Keyboard::isKeyPressed(Key::A))
+        input.buttons |= InputState::Left;
+    if (sf::Keyboard::isKeyPressed(Key::Right) || sf::Keyboard::isKeyPressed(Key::D))
+        input.buttons |= InputState::Right;
+    if (sf::Keyboard::isKeyPressed(Key::Down) || sf::Keyboard::isKeyPressed(Key::S))
+        input.buttons |= InputState::Down;
+    // Salto - SOLO con Up (Space es para fuego)
+    if (sf::Keyboard::isKeyPressed(Key::Up))
+        input.buttons |= InputState::Jump;
+    if (sf::Keyboard::isKeyPressed(Key::Space))
+        input.buttons |= InputState::Fire;
+    return input;
+}
+
+bool GameWindow::isRewindHeld()
+{
+    return sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Backspace);
 }
 
 sf::RenderWindow& GameWindow::window()
 {
     return m_window;
 }
+
+void GameWindow::setFrameRate(unsigned int hz)
+{
+    m_frameRate = hz;
+    m_pacer.setTargetHz(m_vsync ? 0 : hz);
+}
+
+void GameWindow::setVsync(bool enabled)
+{
+    m_vsync = enabled;
+    m_window.setVerticalSyncEnabled(enabled);
+    m_pacer.setTargetHz(enabled ? 0 : m_frameRate);
+}
+
+const FramePacer& GameWindow::pacer() const
+{
+    return m_pacer;
+}
@@ -1,8 +1,10 @@
 #include "Goal.hpp"
+#include "StateBuffer.hpp"
+#include "TextureCache.hpp"
 #include <iostream>
 
 Goal::Goal()
-    : m_sprite(m_texture), m_poleSprite(m_texture), m_x(0), m_y(0), m_triggered(false), 
+    : m_texture(TextureCache::get("assets/images/Goal.png")), m_sprite(m_texture), m_poleSprite(m_texture), m_x(0), m_y(0), m_triggered(false), 
       m_animComplete(false), m_animTimer(0.0f), m_frame(0), m_totalAnimTime(0.0f) {
 }
 
@@ -10,11 +12,6 @@ void Goal::init(float x, float y) {
   m_x = x;
   m_y = y;
   
-  // Load texture
-  if (!m_texture.loadFromFile("assets/images/Goal.png")) {
-    std::cerr << "Error loading Goal.png" << std::endl;
-  }
-  
   // Set up flag sprite (animated) - starts static on frame 1
   m_sprite.setTexture(m_texture);
   m_sprite.setTextureRect(sf::IntRect({SPRITE_X, SPRITE_Y}, {SPRITE_WIDTH, SPRITE_HEIGHT}));
@@ -60,11 +57,16 @@ void Goal::update(float dt) {
   }
 }
 
-void Goal::draw(sf::RenderWindow &window) {
+void Goal::draw(sf::RenderTarget &target) {
   // Draw pole first (behind flag)
-  window.draw(m_poleSprite);
+  target.draw(m_poleSprite);
   // Draw flag/animation on top
-  window.draw(m_sprite);
+  target.draw(m_sprite);
+}
+
+void Goal::snapshot(RenderSnapshot &snapshot) const {
+  snapshot.addSprite(m_poleSprite);
+  snapshot.addSprite(m_sprite);
 }
 
 void Goal::trigger() {
@@ -79,3 +81,27 @@ void Goal::trigger() {
 sf::FloatRect Goal::getBounds() const {
   return m_sprite.getGlobalBounds();
 }
+
+void Goal::saveState(StateWriter &writer) const {
+  writer.write<std::uint8_t>(m_triggered);
+  writer.write<std::uint8_t>(m_animComplete);
+  writer.write(m_animTimer);
+  writer.write<std::int32_t>(m_frame);
+  writer.write(m_totalAnimTime);
+  writer.writeSprite(m_sprite);
+}
+
+bool Goal::loadState(StateReader &reader) {
+  std::uint8_t triggered = 0, animComplete = 0;
+  std::int32_t frame = 0;
+  reader.read(triggered);
+  reader.read(animComplete);
+  reader.read(m_animTimer);
+  reader.read(frame);
+  reader.read(m_totalAnimTime);
+  reader.readSprite(m_sprite);
+  m_triggered = triggered;
+  m_animComplete = animComplete;
+  m_frame = frame;
+  return reader.ok();
+}
@@ -1,15 +1,10 @@
 #include "Goomba.hpp"
+#include "TextureCache.hpp"
 #include <iostream>
 
 Goomba::Goomba(Physics& physics, float x, float y)
-    : Enemy(physics, x, y)
+    : Enemy(physics, TextureCache::get("assets/images/Goomba_koopa.png"), x, y)
 {
-    // Load texture
-    if (!m_texture.loadFromFile("assets/images/Goomba_koopa.png")) {
-        std::cerr << "Error loading Goomba_koopa.png" << std::endl;
-    }
-    m_sprite.setTexture(m_texture);
-    
     // Set initial frame
     m_sprite.setTextureRect(sf::IntRect({SPRITE_OFFSET_X, SPRITE_OFFSET_Y}, {SPRITE_WIDTH, SPRITE_HEIGHT}));
     m_sprite.setOrigin({SPRITE_WIDTH / 2.0f, SPRITE_HEIGHT - 2.0f});
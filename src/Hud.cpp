@@ -0,0 +1,100 @@
+#include "Hud.hpp"
+#include "StaticLayerCache.hpp"
+#include <iostream>
+#include <string>
+
+Hud::Hud(const sf::Font& font, const sf::Texture& helmet, sf::Vector2u size)
+: m_size(size), m_livesText(font), m_helmet(helmet), m_messageText(font),
+  m_thanksText(font), m_bigHelmet(helmet), m_cacheSprite(m_cache.getTexture())
+{
+    m_livesText.setCharacterSize(30);
+    m_livesText.setFillColor(sf::Color::White);
+    m_livesText.setPosition({60.f, 20.f}); // Moved right to make room for helmet icon
+
+    m_helmet.setPosition({15.f, 18.f}); // Aligned with text center
+    m_helmet.setScale({0.5f, 0.5f});
+
+    m_messageText.setCharacterSize(40);
+    m_messageText.setFillColor(sf::Color::White);
+
+    m_thanksText.setCharacterSize(30);
+    m_thanksText.setFillColor(sf::Color::White);
+    m_thanksText.setString("Gracias por Jugar");
+    centerText(m_thanksText, 60.0f);
+
+    m_bigHelmet.setScale({0.8f, 0.8f}); // Larger for center screen
+}
+
+void Hud::centerText(sf::Text& text, float offsetY)
+{
+    sf::FloatRect bounds = text.getLocalBounds();
+    text.setOrigin({bounds.position.x + bounds.size.x / 2.0f,
+                    bounds.position.y + bounds.size.y / 2.0f});
+    text.setPosition({m_size.x / 2.0f, m_size.y / 2.0f + offsetY});
+}
+
+void Hud::rebuild(Screen screen, int value)
+{
+    // The default blend (sf::BlendAlpha) already leaves premultiplied
+    // colour in a transparent target: colour is scaled by SrcAlpha and
+    // alpha by One. draw() composites it accordingly.
+    m_cache.clear(sf::Color::Transparent);
+
+    if (screen == Screen::Playing) {
+        std::string label = (value == 1) ? "Vida: " : "Vidas: ";
+        m_livesText.setString(label + std::to_string(value));
+        m_cache.draw(m_helmet);
+        m_cache.draw(m_livesText);
+    } else if (screen != Screen::None) {
+        if (screen == Screen::Lives) {
+            std::string label = (value == 1) ? " Vida" : " Vidas";
+            m_messageText.setString(std::to_string(value) + label);
+        } else if (screen == Screen::Level) {
+            m_messageText.setString("Nivel " + std::to_string(value));
+        } else {
+            m_messageText.setString("Juego Terminado");
+        }
+        centerText(m_messageText, 0.0f);
+        m_cache.draw(m_messageText);
+
+        if (screen == Screen::Won) {
+            m_cache.draw(m_thanksText);
+        }
+        if (screen == Screen::Lives) {
+            // Position to the left of the text
+            float width = m_messageText.getLocalBounds().size.x;
+            m_bigHelmet.setPosition({m_size.x / 2.0f - width / 2.0f - 60.0f,
+                                     m_size.y / 2.0f - 25.0f});
+            m_cache.draw(m_bigHelmet);
+        }
+    }
+
+    m_cache.display();
+    m_screen = screen;
+    m_value = value;
+}
+
+void Hud::draw(sf::RenderTarget& target, Screen screen, int value)
+{
+    if (screen == Screen::None) {
+        return;
+    }
+    if (!m_cacheReady) {
+        // Created on first use, in the rendering thread's context
+        if (!m_cache.resize(m_size)) {
+            std::cerr << "Error creating the HUD render texture" << std::endl;
+            return;
+        }
+        m_cacheSprite.setTextureRect(sf::IntRect(
+            {0, 0}, {static_cast<int>(m_size.x), static_cast<int>(m_size.y)}));
+        m_cacheReady = true;
+        m_screen = Screen::None;
+    }
+    if (screen != m_screen || value != m_value) {
+        rebuild(screen, value);
+    }
+    target.setView(target.getDefaultView());
+    sf::RenderStates states;
+    states.blendMode = StaticLayerCache::PREMULTIPLIED;
+    target.draw(m_cacheSprite, states);
+}
@@ -0,0 +1,234 @@
+#include "InputTrack.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const char TRACK_MAGIC[4] = {'M', 'R', 'I', 'N'};
+const std::uint8_t TRACK_VERSION = 2; // 1 = no stress spec
+
+void writeVarint(std::ostream& out, std::uint32_t value) {
+    while (value >= 0x80) {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+bool readVarint(std::istream& in, std::uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        int byte = in.get();
+        if (byte == EOF) {
+            return false;
+        }
+        value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+void InputTrack::reset(int levelNumber) {
+    m_level = levelNumber;
+    m_stressSpec.clear();
+    m_runs.clear();
+}
+
+void InputTrack::push(InputState input) {
+    if (!m_runs.empty() && m_runs.back().input.buttons == input.buttons &&
+        m_runs.back().ticks < UINT32_MAX) {
+        m_runs.back().ticks++;
+    } else {
+        m_runs.push_back({1, input});
+    }
+}
+
+void InputTrack::append(InputState input, std::uint32_t ticks) {
+    if (ticks == 0) {
+        return;
+    }
+    if (!m_runs.empty() && m_runs.back().input.buttons == input.buttons &&
+        m_runs.back().ticks <= UINT32_MAX - ticks) {
+        m_runs.back().ticks += ticks;
+    } else {
+        m_runs.push_back({ticks, input});
+    }
+}
+
+void InputTrack::pop() {
+    if (m_runs.empty()) {
+        return;
+    }
+    if (--m_runs.back().ticks == 0) {
+        m_runs.pop_back();
+    }
+}
+
+unsigned long InputTrack::tickCount() const {
+    unsigned long ticks = 0;
+    for (const Run& run : m_runs) {
+        ticks += run.ticks;
+    }
+    return ticks;
+}
+
+bool InputTrack::saveToFile(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Error writing " << path << std::endl;
+        return false;
+    }
+
+    file.write(TRACK_MAGIC, sizeof(TRACK_MAGIC));
+    file.put(static_cast<char>(TRACK_VERSION));
+    file.put(static_cast<char>(m_level));
+    writeVarint(file, static_cast<std::uint32_t>(m_stressSpec.size()));
+    file.write(m_stressSpec.data(), static_cast<std::streamsize>(m_stressSpec.size()));
+    writeVarint(file, static_cast<std::uint32_t>(m_runs.size()));
+    for (const Run& run : m_runs) {
+        writeVarint(file, run.ticks);
+        file.put(static_cast<char>(run.input.buttons));
+    }
+    return static_cast<bool>(file);
+}
+
+bool InputTrack::loadFromFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Error loading " << path << std::endl;
+        return false;
+    }
+
+    char magic[4] = {};
+    file.read(magic, sizeof(magic));
+    int version = file.get();
+    int level = file.get();
+    std::string stressSpec;
+    std::uint32_t length = 0;
+    if (version >= 2 && readVarint(file, length) && length <= 256) {
+        stressSpec.resize(length);
+        file.read(&stressSpec[0], length);
+    }
+    std::uint32_t count = 0;
+    if (!file || !std::equal(magic, magic + 4, TRACK_MAGIC) || version < 1 ||
+        version > TRACK_VERSION || length > 256 || !readVarint(file, count)) {
+        std::cerr << "Error loading " << path << ": not an input track"
+                  << std::endl;
+        return false;
+    }
+
+    std::vector<Run> runs;
+    runs.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        Run run{};
+        int buttons = 0;
+        if (!readVarint(file, run.ticks) || (buttons = file.get()) == EOF) {
+            std::cerr << "Error loading " << path << ": truncated track"
+                      << std::endl;
+            return false;
+        }
+        run.input.buttons = static_cast<std::uint8_t>(buttons);
+        runs.push_back(run);
+    }
+
+    m_level = level;
+    m_stressSpec = std::move(stressSpec);
+    m_runs = std::move(runs);
+    return true;
+}
+
+bool InputTrack::loadScript(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Error opening script " << path << std::endl;
+        return false;
+    }
+
+    std::vector<Run> runs;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream in(line);
+        std::uint32_t ticks = 0;
+        std::string buttons;
+        if (!(in >> ticks)) {
+            continue; // Blank or comment line
+        }
+        in >> buttons;
+
+        InputState input;
+        for (char c : buttons) {
+            switch (c) {
+            case 'L': input.buttons |= InputState::Left; break;
+            case 'R': input.buttons |= InputState::Right; break;
+            case 'D': input.buttons |= InputState::Down; break;
+            case 'J': input.buttons |= InputState::Jump; break;
+            case 'F': input.buttons |= InputState::Fire; break;
+            case '-': break;
+            default:
+                std::cerr << path << ":" << lineNumber << ": unknown button '"
+                          << c << "'" << std::endl;
+                return false;
+            }
+        }
+        if (ticks > 0) {
+            runs.push_back({ticks, input});
+        }
+    }
+
+    m_runs = std::move(runs);
+    return true;
+}
+
+InputTrack InputTrack::randomized(int levelNumber, std::mt19937& rng,
+                                  unsigned long ticks) {
+    std::uniform_int_distribution<std::uint32_t> hold(4, 45);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+    InputTrack track;
+    track.reset(levelNumber);
+    unsigned long total = 0;
+    while (total < ticks) {
+        InputState input;
+        if (chance(rng) < 0.75f) {
+            input.buttons |= InputState::Right;
+        } else if (chance(rng) < 0.5f) {
+            input.buttons |= InputState::Left;
+        }
+        if (chance(rng) < 0.4f) {
+            input.buttons |= InputState::Jump;
+        }
+        if (chance(rng) < 0.1f) {
+            input.buttons |= InputState::Fire;
+        }
+        if (chance(rng) < 0.05f) {
+            input.buttons |= InputState::Down;
+        }
+
+        std::uint32_t length = hold(rng);
+        track.append(input, length);
+        total += length;
+    }
+    return track;
+}
+
+InputState InputPlayback::next() {
+    const std::vector<InputTrack::Run>& runs = m_track->runs();
+    if (m_run >= runs.size()) {
+        return InputState();
+    }
+    InputState input = runs[m_run].input;
+    if (++m_tick >= runs[m_run].ticks) {
+        ++m_run;
+        m_tick = 0;
+    }
+    return input;
+}
@@ -1,14 +1,12 @@
 #include "Item.hpp"
+#include "SpriteSync.hpp"
+#include "StateBuffer.hpp"
+#include "TextureCache.hpp"
 #include <iostream>
 
 Item::Item(Physics& physics, float x, float y)
-: m_physics(physics), m_collected(false), m_spawning(true), m_spawnY(y), m_targetY(y - 32.0f), m_blinkTimer(0.0f), m_visible(true), m_sprite(m_texture)
+: m_physics(physics), m_bodyId(b2_nullBodyId), m_texture(TextureCache::get("assets/images/items.png")), m_sprite(m_texture), m_collected(false), m_spawning(true), m_spawnY(y), m_targetY(y - 32.0f), m_blinkTimer(0.0f), m_visible(true)
 {
-    if (!m_texture.loadFromFile("assets/images/items.png")) {
-        std::cerr << "Error loading items.png" << std::endl;
-    }
-    m_sprite.setTexture(m_texture);
-    
     // Red Mushroom
     // 18x16 sprite. Origin (9, 11) raises sprite 2px above 'perfect' alignment to ensure it sits visibly ON top of floor.
     m_sprite.setTextureRect(sf::IntRect({0, 0}, {18, 16}));
@@ -20,6 +18,30 @@ Item::Item(Physics& physics, float x, float y)
     // For now, no physics body while spawning. We create it after spawn.
 }
 
+Item::~Item() {
+    if (b2Body_IsValid(m_bodyId)) {
+        b2DestroyBody(m_bodyId);
+    }
+}
+
+void Item::createBody() {
+    b2BodyDef bodyDef = b2DefaultBodyDef();
+    bodyDef.type = b2_dynamicBody;
+    // Slightly adjust spawn Y up to ensure no deep overlap with ground
+    bodyDef.position = (b2Vec2){m_sprite.getPosition().x / Physics::SCALE, (m_sprite.getPosition().y - 2.0f) / Physics::SCALE};
+    bodyDef.fixedRotation = true;
+
+    m_bodyId = b2CreateBody(m_physics.worldId(), &bodyDef);
+
+    // Slightly smaller physics box to endure it doesn't snag easily
+    b2Polygon box = b2MakeBox((14.0f / 2.0f) / Physics::SCALE, (14.0f / 2.0f) / Physics::SCALE);
+    b2ShapeDef shapeDef = b2DefaultShapeDef();
+    // shapeDef.friction = 0.0f; // Friction 0 to slide, or small value
+    // shapeDef.restitution = 0.0f;
+
+    b2CreatePolygonShape(m_bodyId, &shapeDef, &box);
+}
+
 void Item::update(float dt) {
     // Blink only during spawn
     if (m_spawning) {
@@ -47,21 +69,7 @@ void Item::update(float dt) {
             m_sprite.setColor(c);
             
             // Create Physics Body now
-            b2BodyDef bodyDef = b2DefaultBodyDef();
-            bodyDef.type = b2_dynamicBody;
-            // Slightly adjust spawn Y up to ensure no deep overlap with ground
-            bodyDef.position = (b2Vec2){m_sprite.getPosition().x / Physics::SCALE, (m_sprite.getPosition().y - 2.0f) / Physics::SCALE};
-            bodyDef.fixedRotation = true;
-
-            m_bodyId = b2CreateBody(m_physics.worldId(), &bodyDef);
-            
-            // Slightly smaller physics box to endure it doesn't snag easily
-            b2Polygon box = b2MakeBox((14.0f / 2.0f) / Physics::SCALE, (14.0f / 2.0f) / Physics::SCALE);
-            b2ShapeDef shapeDef = b2DefaultShapeDef();
-            // shapeDef.friction = 0.0f; // Friction 0 to slide, or small value
-            // shapeDef.restitution = 0.0f;
-            
-            b2CreatePolygonShape(m_bodyId, &shapeDef, &box);
+            createBody();
             
             // Initial Push Right
             b2Body_SetLinearVelocity(m_bodyId, (b2Vec2){2.0f, 0.0f});
@@ -69,8 +77,7 @@ void Item::update(float dt) {
     } else {
         // Sync with Physics
         if (b2Body_IsValid(m_bodyId)) {
-            b2Vec2 pos = b2Body_GetPosition(m_bodyId);
-            m_sprite.setPosition({pos.x * Physics::SCALE, pos.y * Physics::SCALE});
+            SpriteSync::toBody(m_sprite, m_bodyId);
             
             // Maintain horizontal velocity
             b2Vec2 vel = b2Body_GetLinearVelocity(m_bodyId);
@@ -81,9 +88,15 @@ void Item::update(float dt) {
     }
 }
 
-void Item::draw(sf::RenderWindow& window) {
+void Item::draw(sf::RenderTarget& target) {
     if (!m_collected) {
-        window.draw(m_sprite);
+        target.draw(m_sprite);
+    }
+}
+
+void Item::snapshot(RenderSnapshot& snapshot) const {
+    if (!m_collected) {
+        snapshot.addSprite(m_sprite);
     }
 }
 
@@ -94,3 +107,42 @@ void Item::collect() {
         m_bodyId = b2_nullBodyId; 
     }
 }
+
+void Item::saveState(StateWriter& writer) const {
+    writer.write<std::uint8_t>(m_collected);
+    writer.write<std::uint8_t>(m_spawning);
+    writer.write<std::uint8_t>(m_visible);
+    writer.write(m_spawnY);
+    writer.write(m_targetY);
+    writer.write(m_blinkTimer);
+    writer.writeSprite(m_sprite);
+    writer.writeBody(m_bodyId);
+}
+
+bool Item::loadState(StateReader& reader) {
+    std::uint8_t collected = 0, spawning = 0, visible = 0;
+    reader.read(collected);
+    reader.read(spawning);
+    reader.read(visible);
+    reader.read(m_spawnY);
+    reader.read(m_targetY);
+    reader.read(m_blinkTimer);
+    reader.readSprite(m_sprite);
+    BodyState body;
+    reader.readBody(body);
+    if (!reader.ok()) {
+        return false;
+    }
+    m_collected = collected;
+    m_spawning = spawning;
+    m_visible = visible;
+
+    if (body.valid && !b2Body_IsValid(m_bodyId)) {
+        createBody();
+    } else if (!body.valid && b2Body_IsValid(m_bodyId)) {
+        b2DestroyBody(m_bodyId);
+        m_bodyId = b2_nullBodyId;
+    }
+    body.apply(m_bodyId);
+    return true;
+}
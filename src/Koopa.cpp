@@ -1,19 +1,16 @@
 #include "Koopa.hpp"
+#include "SpriteSync.hpp"
+#include "StateBuffer.hpp"
+#include "TextureCache.hpp"
 #include <iostream>
 #include <cmath>
 
 Koopa::Koopa(Physics& physics, float x, float y)
-    : Enemy(physics, x, y)
+    : Enemy(physics, TextureCache::get("assets/images/Goomba_koopa.png"), x, y)
     , m_koopaState(KoopaState::Walking)
     , m_shellFrame(0)
     , m_shellAnimTimer(0.0f)
 {
-    // Load texture (same as Goomba)
-    if (!m_texture.loadFromFile("assets/images/Goomba_koopa.png")) {
-        std::cerr << "Error loading Goomba_koopa.png" << std::endl;
-    }
-    m_sprite.setTexture(m_texture);
-    
     // Set initial frame
     m_sprite.setTextureRect(sf::IntRect({SPRITE_OFFSET_X, SPRITE_OFFSET_Y}, {SPRITE_WIDTH, SPRITE_HEIGHT}));
     m_sprite.setOrigin({SPRITE_WIDTH / 2.0f, SPRITE_HEIGHT});
@@ -54,11 +51,8 @@ void Koopa::update(float dt) {
     // Handle shell state (doesn't use base Enemy update)
     if (m_koopaState == KoopaState::Shell) {
         // Just sit there with static sprite 5 (index 4) - no animation
-        // Sync position only
-        if (b2Body_IsValid(m_bodyId)) {
-            b2Vec2 pos = b2Body_GetPosition(m_bodyId);
-            m_sprite.setPosition({pos.x * Physics::SCALE, pos.y * Physics::SCALE});
-        }
+        // Sync position only (nothing to do once the shell's body sleeps)
+        SpriteSync::toBody(m_sprite, m_bodyId);
         return;
     }
 
@@ -101,8 +95,7 @@ void Koopa::update(float dt) {
         }
         
         if (b2Body_IsValid(m_bodyId)) {
-            b2Vec2 pos = b2Body_GetPosition(m_bodyId);
-            m_sprite.setPosition({pos.x * Physics::SCALE, pos.y * Physics::SCALE});
+            SpriteSync::toBody(m_sprite, m_bodyId);
             
             // Check wall collision to reverse
             b2Vec2 vel = b2Body_GetLinearVelocity(m_bodyId);
@@ -232,26 +225,53 @@ void Koopa::killByFireball() {
     
     // Recreate body as dynamic to fall with physics
     if (b2Body_IsValid(m_bodyId)) {
-        b2Vec2 pos = b2Body_GetPosition(m_bodyId);
-        b2DestroyBody(m_bodyId);
-        
-        b2BodyDef bodyDef = b2DefaultBodyDef();
-        bodyDef.type = b2_dynamicBody;
-        bodyDef.position = pos;
-        bodyDef.fixedRotation = true;
-        
-        m_bodyId = b2CreateBody(m_physics.worldId(), &bodyDef);
-        
-        // Add shape with no collision filter (falls through everything)
-        b2Polygon box = b2MakeBox((SHELL_WIDTH / 2.0f) / Physics::SCALE, (SHELL_HEIGHT / 2.0f) / Physics::SCALE);
-        b2ShapeDef shapeDef = b2DefaultShapeDef();
-        shapeDef.density = 1.0f;
-        shapeDef.filter.categoryBits = 0;
-        shapeDef.filter.maskBits = 0;
-        
-        b2CreatePolygonShape(m_bodyId, &shapeDef, &box);
+        createDyingBody(b2Body_GetPosition(m_bodyId));
         
         // Jump up before falling
         b2Body_SetLinearVelocity(m_bodyId, (b2Vec2){0.0f, -10.0f});
     }
 }
+
+void Koopa::createDyingBody(b2Vec2 position) {
+    if (b2Body_IsValid(m_bodyId)) {
+        b2DestroyBody(m_bodyId);
+    }
+
+    b2BodyDef bodyDef = b2DefaultBodyDef();
+    bodyDef.type = b2_dynamicBody;
+    bodyDef.position = position;
+    bodyDef.fixedRotation = true;
+    
+    m_bodyId = b2CreateBody(m_physics.worldId(), &bodyDef);
+    
+    // Add shape with no collision filter (falls through everything)
+    b2Polygon box = b2MakeBox((SHELL_WIDTH / 2.0f) / Physics::SCALE, (SHELL_HEIGHT / 2.0f) / Physics::SCALE);
+    b2ShapeDef shapeDef = b2DefaultShapeDef();
+    shapeDef.density = 1.0f;
+    shapeDef.filter.categoryBits = 0;
+    shapeDef.filter.maskBits = 0;
+    
+    b2CreatePolygonShape(m_bodyId, &shapeDef, &box);
+}
+
+void Koopa::saveExtra(StateWriter& writer) const {
+    writer.write(m_koopaState);
+    writer.write<std::int32_t>(m_shellFrame);
+    writer.write(m_shellAnimTimer);
+}
+
+void Koopa::loadExtra(StateReader& reader) {
+    std::int32_t shellFrame = 0;
+    reader.read(m_koopaState);
+    reader.read(shellFrame);
+    reader.read(m_shellAnimTimer);
+    m_shellFrame = shellFrame;
+}
+
+void Koopa::restoreBody(const BodyState& body) {
+    // A freshly built Koopa has the walking body; the dying one differs
+    if (body.valid && m_koopaState == KoopaState::ShellDying) {
+        createDyingBody(body.position);
+    }
+    Enemy::restoreBody(body);
+}
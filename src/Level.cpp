@@ -1,7 +1,14 @@
 #include "Level.hpp"
 #include "Player.hpp"
+#include "StateBuffer.hpp"
+#include "TextureCache.hpp"
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
 #include <iostream>
+#include <random>
+#include <sstream>
 
 // ============================================================================
 // DEBUG: Descomentar la siguiente línea para poner la meta cerca del inicio
@@ -10,35 +17,44 @@
 // ============================================================================
 // #define DEBUG_SKIP_LEVEL
 
-Level::Level(Physics &physics, float width, float height, int levelNumber)
-    : m_physics(physics), m_width(width), m_height(height),
-      m_stompCooldown(0.0f), m_stompSound(m_stompSoundBuffer),
-      m_powerupSound(m_powerupSoundBuffer), m_goalSound(m_goalSoundBuffer),
-      m_levelNumber(levelNumber), m_bgSprite(m_bgTexture),
-      m_cornerSprite(m_bgTexture) {
-  // Load Textures
-  if (!m_texture.loadFromFile("assets/images/tilesets.png")) {
-    std::cerr << "Error loading tilesets.png" << std::endl;
-  }
-  if (!m_texture2.loadFromFile("assets/images/plataformas.png")) {
-    std::cerr << "Error loading plataformas.png" << std::endl;
-  }
+// ============================================================================
+// DEBUG: Descomentar para ver en consola los eventos del juego (pisotones,
+//        bolas de fuego, meta). Desactivado por defecto: imprimir desde el
+//        tick es lento y ensucia la salida de las herramientas.
+// ============================================================================
+// #define DEBUG_TRACE
 
-  // Load Stomp Sound
-  if (!m_stompSoundBuffer.loadFromFile("assets/music/aplastar.mp3")) {
-    std::cerr << "Error loading aplastar.mp3" << std::endl;
-  }
+#ifdef DEBUG_TRACE
+#define LEVEL_TRACE(message) (std::cout << message << std::endl)
+#else
+#define LEVEL_TRACE(message) ((void)0)
+#endif
 
-  // Load Powerup Sound
-  if (!m_powerupSoundBuffer.loadFromFile("assets/music/powerup.wav")) {
-    std::cerr << "Error loading powerup.wav" << std::endl;
-  }
+namespace {
+// Bloque trampa ya reducido a 32x32 (BakedAsset "trampa"): se dibuja sin escalar
+const sf::IntRect TRAP_RECT({0, 0}, {32, 32});
+} // namespace
 
-  // Load Goal Sound
-  if (!m_goalSoundBuffer.loadFromFile("assets/music/goal_sound.wav")) {
-    std::cerr << "Error loading goal_sound.wav" << std::endl;
-  }
+Level::Level(Physics &physics, float width, float height, int levelNumber,
+             GameEventQueue *events)
+    : Level(physics, width, height, levelNumber, DEFAULT_LEVEL_WIDTH, events) {}
 
+Level::Level(Physics &physics, float width, float height,
+             const StressLevelSpec &spec, GameEventQueue *events)
+    : Level(physics, width, height, STRESS_LEVEL, spec.width, events) {
+  generateStressContent(spec);
+}
+
+Level::Level(Physics &physics, float width, float height, int levelNumber,
+             float levelWidth, GameEventQueue *events)
+    : m_physics(physics),
+      m_texture(TextureCache::get("assets/images/tilesets.png")),
+      m_texture2(TextureCache::get("assets/images/plataformas.png")),
+      m_width(width), m_height(height), m_levelWidth(levelWidth),
+      m_levelNumber(levelNumber), m_stompCooldown(0.0f),
+      m_trapTexture(TextureCache::getBaked("trampa")),
+      m_bgTexture(TextureCache::get("assets/images/background.png")),
+      m_cornerSprite(m_bgTexture), m_events(events) {
   // Initialize Goal
 #ifdef DEBUG_SKIP_LEVEL
   // DEBUG: Meta cerca del inicio SOLO en nivel 1 para saltar rápidamente al
@@ -46,26 +62,13 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
   if (m_levelNumber == 1) {
     m_goal.init(200.0f, height - 32.0f);
   } else {
-    m_goal.init(LEVEL_WIDTH - 200.0f, height - 32.0f);
+    m_goal.init(m_levelWidth - 200.0f, height - 32.0f);
   }
 #else
   // NORMAL: Meta al final del nivel
-  m_goal.init(LEVEL_WIDTH - 200.0f, height - 32.0f);
+  m_goal.init(m_levelWidth - 200.0f, height - 32.0f);
 #endif
 
-  // Load Background Texture
-  if (!m_bgTexture.loadFromFile("assets/images/background.png")) {
-    std::cerr << "Error loading background.png" << std::endl;
-  }
-  // Load Trap Texture (for kill blocks)
-  if (!m_trapTexture.loadFromFile("assets/images/trampa.png")) {
-    std::cerr << "Error loading trampa.png" << std::endl;
-  }
-  // Ensure bgSprite uses the texture (for the main background loop)
-  m_bgSprite.setTexture(m_bgTexture);
-  m_bgSprite.setTextureRect(
-      sf::IntRect(sf::Vector2i(0, 0), sf::Vector2i(1600, 750)));
-
   // Configure corner sprite (spray)
   // Region: (0, 748) is bottom-left. 74x74 up/right.
   // SFML IntRect(left, top, width, height) -> Top = 748 - 74 = 674.
@@ -77,11 +80,18 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
   // Config Setup
   m_groundY = height - 32.0f;
 
+  // Fondo: la región 1600x750 de background.png repetida, apoyada en el
+  // suelo y desplazándose con el mundo
+  m_background.addLayer(
+      TextureCache::getTiled("assets/images/background.png",
+                             sf::IntRect({0, 0}, {1600, 750})),
+      m_groundY - 750.0f, 750.0f, 1.0f);
+
   // Usar tiles de 32x32 en pantalla (sprite 16x16 escalado a 2x)
   static constexpr int DISPLAY_TILE_SIZE =
       32;                                  // Tamaño en pantalla (escalado 2x)
   static constexpr int TEX_TILE_SIZE = 16; // Tamaño del sprite en textura
-  int numTilesX = static_cast<int>(LEVEL_WIDTH / DISPLAY_TILE_SIZE) + 1;
+  int numTilesX = static_cast<int>(m_levelWidth / DISPLAY_TILE_SIZE) + 1;
 
   // Sección alternativa: desde X=640 por 17 bloques
   static constexpr int ALT_START_TILE = 640 / DISPLAY_TILE_SIZE; // Tile 20
@@ -93,19 +103,29 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
   static constexpr int THIRD_START_TILE = 1184 / DISPLAY_TILE_SIZE;  // Tile 37
   static constexpr int FOURTH_START_TILE = 4800 / DISPLAY_TILE_SIZE; // Tile 150
 
-  int thirdNumTiles = FOURTH_START_TILE - THIRD_START_TILE;
-  int fourthNumTiles = numTilesX - FOURTH_START_TILE;
+  // Las secciones son del diseño de los niveles numerados; un nivel
+  // generado (de cualquier ancho) es una sola tira de suelo normal
+  bool sectioned = m_levelNumber != STRESS_LEVEL;
+  int altNumTiles =
+      sectioned ? std::max(0, std::min(ALT_NUM_TILES, numTilesX - ALT_START_TILE))
+                : 0;
+  int thirdNumTiles =
+      sectioned ? std::max(0, std::min(numTilesX, FOURTH_START_TILE) -
+                                  THIRD_START_TILE)
+                : 0;
+  int fourthNumTiles =
+      sectioned ? std::max(0, numTilesX - FOURTH_START_TILE) : 0;
 
   // Contar tiles normales (excluyendo las secciones alternativa, tercera y
   // cuarta)
-  int normalTiles = numTilesX - ALT_NUM_TILES - thirdNumTiles - fourthNumTiles;
+  int normalTiles = numTilesX - altNumTiles - thirdNumTiles - fourthNumTiles;
 
   m_groundVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
   m_groundVertices.resize(normalTiles * 6);
 
   // Segundo VertexArray para la sección alternativa
   m_groundVertices2.setPrimitiveType(sf::PrimitiveType::Triangles);
-  m_groundVertices2.resize(ALT_NUM_TILES * 6);
+  m_groundVertices2.resize(altNumTiles * 6);
 
   // Tercer VertexArray para la tercera sección
   m_groundVertices3.setPrimitiveType(sf::PrimitiveType::Triangles);
@@ -152,9 +172,11 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
     sf::Vector2f p3(x, y + DISPLAY_TILE_SIZE);
 
     // Determinar qué sección usar
-    bool isAltSection = (i >= ALT_START_TILE && i < ALT_END_TILE);
-    bool isThirdSection = (i >= THIRD_START_TILE && i < FOURTH_START_TILE);
-    bool isFourthSection = (i >= FOURTH_START_TILE);
+    bool isAltSection =
+        sectioned && i >= ALT_START_TILE && i < ALT_END_TILE;
+    bool isThirdSection =
+        sectioned && i >= THIRD_START_TILE && i < FOURTH_START_TILE;
+    bool isFourthSection = sectioned && i >= FOURTH_START_TILE;
 
     if (isFourthSection) {
       // Usar cuarta textura (tilesets.png sprite 320,16)
@@ -281,13 +303,14 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
                                  (16.0f) / Physics::SCALE);
       b2ShapeDef sd = b2DefaultShapeDef();
       b2CreatePolygonShape(s1, &sd, &box1);
+      m_solidRects.push_back(sf::FloatRect({0.0f, m_groundY}, {p1Width, 32.0f}));
     }
-    // Part 2: [5920, LEVEL_WIDTH]
+    // Part 2: [5920, m_levelWidth]
     // Start = 160 + 180*32 = 5920.
     // Width = 6400 - 5920 = 480.
     {
       float gapEnd = 160.0f + 180.0f * 32.0f; // 5920
-      float p2Width = LEVEL_WIDTH - gapEnd;   // 480
+      float p2Width = m_levelWidth - gapEnd;   // 480
       if (p2Width > 0) {
         b2BodyDef groundDef = b2DefaultBodyDef();
         float p2CenterX = gapEnd + p2Width / 2.0f;
@@ -299,6 +322,8 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
                                    (16.0f) / Physics::SCALE);
         b2ShapeDef sd = b2DefaultShapeDef();
         b2CreatePolygonShape(s2, &sd, &box2);
+        m_solidRects.push_back(
+            sf::FloatRect({gapEnd, m_groundY}, {p2Width, 32.0f}));
 
         // Assign main ID to one of them (or leave it unused if not critical,
         // but let's assign the end piece)
@@ -308,21 +333,23 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
   } else {
     // Original Logic (Level 1 / Default)
     b2BodyDef groundDef = b2DefaultBodyDef();
-    // Usar LEVEL_WIDTH para el cuerpo físico del suelo
-    groundDef.position = (b2Vec2){(LEVEL_WIDTH / 2.0f) / Physics::SCALE,
+    // Usar m_levelWidth para el cuerpo físico del suelo
+    groundDef.position = (b2Vec2){(m_levelWidth / 2.0f) / Physics::SCALE,
                                   (m_groundY + 16.0f) / Physics::SCALE};
     groundDef.type = b2_staticBody;
 
     m_groundBodyId = b2CreateBody(m_physics.worldId(), &groundDef);
 
-    // Forma - usar LEVEL_WIDTH para cubrir todo el nivel
-    float halfWidth = (LEVEL_WIDTH / 2.0f) / Physics::SCALE;
+    // Forma - usar m_levelWidth para cubrir todo el nivel
+    float halfWidth = (m_levelWidth / 2.0f) / Physics::SCALE;
     float halfHeight = (32.0f / 2.0f) / Physics::SCALE;
     b2Polygon groundBox = b2MakeBox(halfWidth, halfHeight);
 
     // Fixture
     b2ShapeDef fixtureDef = b2DefaultShapeDef();
     b2CreatePolygonShape(m_groundBodyId, &fixtureDef, &groundBox);
+    m_solidRects.push_back(
+        sf::FloatRect({0.0f, m_groundY}, {m_levelWidth, 32.0f}));
   }
 
   // Muro Izquierdo (Invisible)
@@ -337,6 +364,7 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
       b2MakeBox(10.0f / Physics::SCALE, (height / 2.0f) / Physics::SCALE);
   b2ShapeDef wallShapeDef = b2DefaultShapeDef();
   b2CreatePolygonShape(wallId, &wallShapeDef, &wallBox);
+  m_solidRects.push_back(sf::FloatRect({-20.0f, 0.0f}, {20.0f, height}));
 
   // ========== LEVEL-SPECIFIC CONTENT ==========
   if (m_levelNumber == 1) {
@@ -357,68 +385,59 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
     //     std::make_unique<Goomba>(m_physics, 320.0f, m_groundY - 96.0f));
 
     // Goomba en X=416, nivel del suelo
-    m_enemies.push_back(std::make_unique<Goomba>(m_physics, 416.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 416.0f, m_groundY);
 
     // Koopa en X=578, nivel del suelo
-    m_enemies.push_back(std::make_unique<Koopa>(m_physics, 578.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Koopa, 578.0f, m_groundY);
 
     // Goomba en X=864, nivel del suelo
-    m_enemies.push_back(std::make_unique<Goomba>(m_physics, 864.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 864.0f, m_groundY);
 
     // Koopa en X=1056, nivel del suelo
-    m_enemies.push_back(std::make_unique<Koopa>(m_physics, 1056.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Koopa, 1056.0f, m_groundY);
 
     // Goomba en X=1504, nivel del suelo
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 1504.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 1504.0f, m_groundY);
 
     // Goomba en X=1664, nivel del suelo
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 1664.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 1664.0f, m_groundY);
 
     // Goomba en X=1824, nivel del suelo
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 1824.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 1824.0f, m_groundY);
 
     // Goomba en X=2016, altura 5 bloques (160px) sobre el suelo
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 2016.0f, m_groundY - 160.0f));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 2016.0f, m_groundY - 160.0f);
 
     // Goomba en X=2112, altura 8 bloques (256px) sobre el suelo
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 2112.0f, m_groundY - 256.0f));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 2112.0f, m_groundY - 256.0f);
 
     // Goomba en X=2208, altura 8 bloques (256px) sobre el suelo
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 2208.0f, m_groundY - 256.0f));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 2208.0f, m_groundY - 256.0f);
 
     // Goomba en X=3104 eliminado
     // m_enemies.push_back(std::make_unique<Goomba>(m_physics, 3104.0f,
     // m_groundY));
 
     // Goomba en X=3264 cambiado a Koopa
-    m_enemies.push_back(std::make_unique<Koopa>(m_physics, 3264.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Koopa, 3264.0f, m_groundY);
 
     // Koopa en X=3424, nivel del suelo
-    m_enemies.push_back(std::make_unique<Koopa>(m_physics, 3424.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Koopa, 3424.0f, m_groundY);
 
     // Koopa en X=3840, nivel del suelo
-    m_enemies.push_back(std::make_unique<Koopa>(m_physics, 3840.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Koopa, 3840.0f, m_groundY);
 
     // Koopa en X=3936, nivel del suelo
-    m_enemies.push_back(std::make_unique<Koopa>(m_physics, 3936.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Koopa, 3936.0f, m_groundY);
 
     // Goomba en X=4288, nivel del suelo
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 4288.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 4288.0f, m_groundY);
 
     // Goomba en X=4448, nivel del suelo
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 4448.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 4448.0f, m_groundY);
 
     // Goomba en X=4704, nivel del suelo
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 4704.0f, m_groundY));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 4704.0f, m_groundY);
 
     // Plataforma con textura en X=320, 96px arriba del suelo (3 bloques de
     // ancho)
@@ -1794,15 +1813,9 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
       kBlock.shape.setFillColor(sf::Color::Red);
 
       // Sprite Configuration
-      // Texture already set in constructor
-      // Crop: from (26, 286) with size 434x173
-      kBlock.sprite.setTextureRect(sf::IntRect({26, 286}, {434, 173}));
-
-      // Scale to fit 32x32 block
-      // Desired / Original
-      float scaleX = 32.0f / 434.0f;
-      float scaleY = 32.0f / 173.0f;
-      kBlock.sprite.setScale({scaleX, scaleY});
+      // Texture already set in constructor: the (26, 286) 434x173 crop,
+      // pre-scaled to the 32x32 block (BakedAsset "trampa")
+      kBlock.sprite.setTextureRect(TRAP_RECT);
 
       // VISUAL POSITION: Original x (centered visually)
       kBlock.sprite.setPosition({x, kBlock.y});
@@ -1864,11 +1877,7 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
         kBlock.shape.setFillColor(sf::Color::Red);
 
         // Sprite Configuration
-        kBlock.sprite.setTextureRect(sf::IntRect({26, 286}, {434, 173}));
-
-        float scaleX = 32.0f / 434.0f;
-        float scaleY = 32.0f / 173.0f;
-        kBlock.sprite.setScale({scaleX, scaleY});
+        kBlock.sprite.setTextureRect(TRAP_RECT);
 
         // VISUAL POSITION: Original x (centered visually)
         kBlock.sprite.setPosition({x, kBlock.y});
@@ -1882,66 +1891,8 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
     // Ground and physics bodies were already created above
     // All platforms use tilesets.png sprite at (160,96) 16x16 scaled to 32x32
 
-    // Helper lambda to create a textured platform
     auto createTexturedPlatform = [&](float pX, float pY, float pW, float pH) {
-      Platform plat;
-      plat.x = pX;
-      plat.y = pY;
-      plat.width = pW;
-      plat.height = pH;
-
-      // Physics Body
-      b2BodyDef platBodyDef = b2DefaultBodyDef();
-      platBodyDef.type = b2_staticBody;
-      platBodyDef.position = (b2Vec2){(pX + pW / 2.0f) / Physics::SCALE,
-                                      (pY + pH / 2.0f) / Physics::SCALE};
-      plat.bodyId = b2CreateBody(m_physics.worldId(), &platBodyDef);
-
-      b2Polygon platBox =
-          b2MakeBox((pW / 2.0f) / Physics::SCALE, (pH / 2.0f) / Physics::SCALE);
-      b2ShapeDef platShapeDef = b2DefaultShapeDef();
-      b2CreatePolygonShape(plat.bodyId, &platShapeDef, &platBox);
-
-      // Visual with tiles from tilesets.png (160,96) 16x16 scaled to 32x32
-      int tilesX = static_cast<int>(pW / 32.0f);
-      int tilesY = static_cast<int>(pH / 32.0f);
-      plat.vertices.setPrimitiveType(sf::PrimitiveType::Triangles);
-      plat.vertices.resize(tilesX * tilesY * 6);
-
-      for (int ty = 0; ty < tilesY; ++ty) {
-        for (int tx = 0; tx < tilesX; ++tx) {
-          int idx = (ty * tilesX + tx) * 6;
-          float px = pX + tx * 32.0f;
-          float py = pY + ty * 32.0f;
-
-          // Quad positions (32x32 on screen)
-          sf::Vector2f p0(px, py);
-          sf::Vector2f p1(px + 32.0f, py);
-          sf::Vector2f p2(px + 32.0f, py + 32.0f);
-          sf::Vector2f p3(px, py + 32.0f);
-
-          // Texture coords (16x16 in image at 160,96)
-          sf::Vector2f t0(160.0f, 96.0f);
-          sf::Vector2f t1(176.0f, 96.0f);
-          sf::Vector2f t2(176.0f, 112.0f);
-          sf::Vector2f t3(160.0f, 112.0f);
-
-          plat.vertices[idx + 0].position = p0;
-          plat.vertices[idx + 0].texCoords = t0;
-          plat.vertices[idx + 1].position = p1;
-          plat.vertices[idx + 1].texCoords = t1;
-          plat.vertices[idx + 2].position = p2;
-          plat.vertices[idx + 2].texCoords = t2;
-          plat.vertices[idx + 3].position = p2;
-          plat.vertices[idx + 3].texCoords = t2;
-          plat.vertices[idx + 4].position = p3;
-          plat.vertices[idx + 4].texCoords = t3;
-          plat.vertices[idx + 5].position = p0;
-          plat.vertices[idx + 5].texCoords = t0;
-        }
-      }
-
-      m_platforms.push_back(plat);
+      addTexturedPlatform(pX, pY, pW, pH, {160.0f, 96.0f});
     };
 
     // Power-up blocks for Level 2
@@ -1952,105 +1903,53 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
 
     // Goombas for Level 2
     // Group 1: X=1568, 8 blocks high (256px), 4 goombas every 2 blocks (64px)
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 1568.0f, m_groundY - 256.0f));
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 1632.0f, m_groundY - 256.0f));
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 1696.0f, m_groundY - 256.0f));
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 1760.0f, m_groundY - 256.0f));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 1568.0f, m_groundY - 256.0f);
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 1632.0f, m_groundY - 256.0f);
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 1696.0f, m_groundY - 256.0f);
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 1760.0f, m_groundY - 256.0f);
 
     // Group 2: X=2240, 13 blocks high (416px), 5 goombas every 2 blocks (64px)
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 2240.0f, m_groundY - 416.0f));
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 2304.0f, m_groundY - 416.0f));
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 2368.0f, m_groundY - 416.0f));
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 2432.0f, m_groundY - 416.0f));
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 2496.0f, m_groundY - 416.0f));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 2240.0f, m_groundY - 416.0f);
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 2304.0f, m_groundY - 416.0f);
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 2368.0f, m_groundY - 416.0f);
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 2432.0f, m_groundY - 416.0f);
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 2496.0f, m_groundY - 416.0f);
 
     // Group 3: X=2784, 7 blocks high (224px), 5 goombas every 5 blocks (160px)
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 2784.0f, m_groundY - 224.0f));
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 2944.0f, m_groundY - 224.0f));
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 3104.0f, m_groundY - 224.0f));
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 3264.0f, m_groundY - 224.0f));
-    m_enemies.push_back(
-        std::make_unique<Goomba>(m_physics, 3424.0f, m_groundY - 224.0f));
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 2784.0f, m_groundY - 224.0f);
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 2944.0f, m_groundY - 224.0f);
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 3104.0f, m_groundY - 224.0f);
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 3264.0f, m_groundY - 224.0f);
+    addEnemySpawn(EnemySpawn::Kind::Goomba, 3424.0f, m_groundY - 224.0f);
 
     // Kill Blocks for Level 2
-    // Helper lambda to create a kill block
-    auto createKillBlock = [&](float x, float heightBlocks) {
-      float blockY = m_groundY - (heightBlocks * 32.0f);
-
-      KillBlock kBlock(m_trapTexture);
-
-      kBlock.x = x + 8.0f; // Offset collision
-      kBlock.y = blockY;
-      kBlock.width = 16.0f;
-      kBlock.height = 32.0f;
-
-      // Physics Body (Static)
-      b2BodyDef bodyDef = b2DefaultBodyDef();
-      bodyDef.type = b2_staticBody;
-      bodyDef.position =
-          (b2Vec2){(kBlock.x + kBlock.width / 2.0f) / Physics::SCALE,
-                   (kBlock.y + kBlock.height / 2.0f) / Physics::SCALE};
-      kBlock.bodyId = b2CreateBody(m_physics.worldId(), &bodyDef);
-
-      b2Polygon box = b2MakeBox((kBlock.width / 2.0f) / Physics::SCALE,
-                                (kBlock.height / 2.0f) / Physics::SCALE);
-      b2ShapeDef shapeDef = b2DefaultShapeDef();
-      b2CreatePolygonShape(kBlock.bodyId, &shapeDef, &box);
-
-      // Visual Shape
-      kBlock.shape.setSize({kBlock.width, kBlock.height});
-      kBlock.shape.setPosition({kBlock.x, kBlock.y});
-      kBlock.shape.setFillColor(sf::Color::Red);
-
-      // Sprite Configuration
-      kBlock.sprite.setTextureRect(sf::IntRect({26, 286}, {434, 173}));
-      float scaleX = 32.0f / 434.0f;
-      float scaleY = 32.0f / 173.0f;
-      kBlock.sprite.setScale({scaleX, scaleY});
-      kBlock.sprite.setPosition({x, kBlock.y});
-
-      m_killBlocks.push_back(kBlock);
-    };
 
     // Group 1: X=2838, 7 blocks high (224px), 5 kill blocks every 5 blocks
     // (160px)
-    createKillBlock(2838.0f, 7.0f);
-    createKillBlock(2998.0f, 7.0f);
-    createKillBlock(3158.0f, 7.0f);
-    createKillBlock(3318.0f, 7.0f);
-    createKillBlock(3478.0f, 7.0f);
+    addKillBlock(2838.0f, 7.0f);
+    addKillBlock(2998.0f, 7.0f);
+    addKillBlock(3158.0f, 7.0f);
+    addKillBlock(3318.0f, 7.0f);
+    addKillBlock(3478.0f, 7.0f);
 
     // Group 2: X=4416, 10 blocks high (320px)
     // First pair (2 blocks)
-    createKillBlock(4416.0f, 10.0f);
-    createKillBlock(4448.0f, 10.0f);
+    addKillBlock(4416.0f, 10.0f);
+    addKillBlock(4448.0f, 10.0f);
     // Second pair moved 1 block left (from 4640 to 4608)
-    createKillBlock(4608.0f, 10.0f);
-    createKillBlock(4640.0f, 10.0f);
+    addKillBlock(4608.0f, 10.0f);
+    addKillBlock(4640.0f, 10.0f);
 
     // Group 3: X=5120, 4 blocks high (128px)
     // First triplet (3 blocks)
-    createKillBlock(5120.0f, 4.0f);
-    createKillBlock(5152.0f, 4.0f);
-    createKillBlock(5184.0f, 4.0f);
+    addKillBlock(5120.0f, 4.0f);
+    addKillBlock(5152.0f, 4.0f);
+    addKillBlock(5184.0f, 4.0f);
     // Second triplet starts at 5216 + 160 = 5376 (5 blocks from end of first
     // triplet)
-    createKillBlock(5376.0f, 4.0f);
-    createKillBlock(5408.0f, 4.0f);
-    createKillBlock(5440.0f, 4.0f);
+    addKillBlock(5376.0f, 4.0f);
+    addKillBlock(5408.0f, 4.0f);
+    addKillBlock(5440.0f, 4.0f);
 
     // PLATFORM 1: X=225, 3 blocks high, 3 blocks wide
     createTexturedPlatform(225.0f, m_groundY - 96.0f, 96.0f, 32.0f);
@@ -2114,6 +2013,180 @@ Level::Level(Physics &physics, float width, float height, int levelNumber)
   }
 }
 
+void Level::addTexturedPlatform(float pX, float pY, float pW, float pH,
+                                sf::Vector2f tile) {
+  Platform plat;
+  plat.x = pX;
+  plat.y = pY;
+  plat.width = pW;
+  plat.height = pH;
+
+  // Physics Body
+  b2BodyDef platBodyDef = b2DefaultBodyDef();
+  platBodyDef.type = b2_staticBody;
+  platBodyDef.position = (b2Vec2){(pX + pW / 2.0f) / Physics::SCALE,
+                                  (pY + pH / 2.0f) / Physics::SCALE};
+  plat.bodyId = b2CreateBody(m_physics.worldId(), &platBodyDef);
+
+  b2Polygon platBox =
+      b2MakeBox((pW / 2.0f) / Physics::SCALE, (pH / 2.0f) / Physics::SCALE);
+  b2ShapeDef platShapeDef = b2DefaultShapeDef();
+  b2CreatePolygonShape(plat.bodyId, &platShapeDef, &platBox);
+
+  // Visual with tiles from tilesets.png (16x16) scaled to 32x32
+  int tilesX = static_cast<int>(pW / 32.0f);
+  int tilesY = static_cast<int>(pH / 32.0f);
+  plat.vertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+  plat.vertices.resize(tilesX * tilesY * 6);
+
+  for (int ty = 0; ty < tilesY; ++ty) {
+    for (int tx = 0; tx < tilesX; ++tx) {
+      int idx = (ty * tilesX + tx) * 6;
+      float px = pX + tx * 32.0f;
+      float py = pY + ty * 32.0f;
+
+      // Quad positions (32x32 on screen)
+      sf::Vector2f p0(px, py);
+      sf::Vector2f p1(px + 32.0f, py);
+      sf::Vector2f p2(px + 32.0f, py + 32.0f);
+      sf::Vector2f p3(px, py + 32.0f);
+
+      // Texture coords (16x16 in image)
+      sf::Vector2f t0(tile.x, tile.y);
+      sf::Vector2f t1(tile.x + 16.0f, tile.y);
+      sf::Vector2f t2(tile.x + 16.0f, tile.y + 16.0f);
+      sf::Vector2f t3(tile.x, tile.y + 16.0f);
+
+      plat.vertices[idx + 0].position = p0;
+      plat.vertices[idx + 0].texCoords = t0;
+      plat.vertices[idx + 1].position = p1;
+      plat.vertices[idx + 1].texCoords = t1;
+      plat.vertices[idx + 2].position = p2;
+      plat.vertices[idx + 2].texCoords = t2;
+      plat.vertices[idx + 3].position = p2;
+      plat.vertices[idx + 3].texCoords = t2;
+      plat.vertices[idx + 4].position = p3;
+      plat.vertices[idx + 4].texCoords = t3;
+      plat.vertices[idx + 5].position = p0;
+      plat.vertices[idx + 5].texCoords = t0;
+    }
+  }
+
+  m_platforms.push_back(plat);
+}
+
+void Level::addKillBlock(float x, float heightBlocks) {
+  float blockY = m_groundY - (heightBlocks * 32.0f);
+
+  KillBlock kBlock(m_trapTexture);
+
+  kBlock.x = x + 8.0f; // Offset collision
+  kBlock.y = blockY;
+  kBlock.width = 16.0f;
+  kBlock.height = 32.0f;
+
+  // Physics Body (Static)
+  b2BodyDef bodyDef = b2DefaultBodyDef();
+  bodyDef.type = b2_staticBody;
+  bodyDef.position =
+      (b2Vec2){(kBlock.x + kBlock.width / 2.0f) / Physics::SCALE,
+               (kBlock.y + kBlock.height / 2.0f) / Physics::SCALE};
+  kBlock.bodyId = b2CreateBody(m_physics.worldId(), &bodyDef);
+
+  b2Polygon box = b2MakeBox((kBlock.width / 2.0f) / Physics::SCALE,
+                            (kBlock.height / 2.0f) / Physics::SCALE);
+  b2ShapeDef shapeDef = b2DefaultShapeDef();
+  b2CreatePolygonShape(kBlock.bodyId, &shapeDef, &box);
+
+  // Visual Shape
+  kBlock.shape.setSize({kBlock.width, kBlock.height});
+  kBlock.shape.setPosition({kBlock.x, kBlock.y});
+  kBlock.shape.setFillColor(sf::Color::Red);
+
+  // Sprite Configuration
+  kBlock.sprite.setTextureRect(TRAP_RECT);
+  kBlock.sprite.setPosition({x, kBlock.y});
+
+  m_killBlocks.push_back(kBlock);
+}
+
+void Level::generateStressContent(const StressLevelSpec &spec) {
+  // Everything lands between the start area and the goal, on the 32px grid
+  // of the hand-made levels, through the same helpers they use
+  std::mt19937 rng(spec.seed);
+  std::uniform_real_distribution<float> span(
+      512.0f, std::max(544.0f, m_levelWidth - 400.0f));
+  auto column = [&]() { return std::floor(span(rng) / 32.0f) * 32.0f; };
+  std::uniform_int_distribution<int> blocksUp(3, 14);
+  std::uniform_int_distribution<int> tiles(1, 10);
+  std::uniform_int_distribution<int> hazardUp(1, 12);
+
+  m_platforms.reserve(m_platforms.size() + spec.platforms);
+  for (int i = 0; i < spec.platforms; ++i) {
+    float x = column();
+    float y = m_groundY - blocksUp(rng) * 32.0f;
+    addTexturedPlatform(x, y, tiles(rng) * 32.0f, 32.0f, {160.0f, 96.0f});
+  }
+
+  m_killBlocks.reserve(m_killBlocks.size() + spec.hazards);
+  for (int i = 0; i < spec.hazards; ++i) {
+    float x = column();
+    addKillBlock(x, static_cast<float>(hazardUp(rng)));
+  }
+
+  // Block centers sit half a tile off the grid (see level 1)
+  m_blocks.reserve(m_blocks.size() + spec.blocks);
+  for (int i = 0; i < spec.blocks; ++i) {
+    float x = column() + 16.0f;
+    float y = m_groundY - 16.0f - blocksUp(rng) * 32.0f;
+    m_blocks.emplace_back(m_physics, x, y);
+  }
+
+  for (int i = 0; i < spec.enemies; ++i) {
+    float x = column() + 16.0f;
+    addEnemySpawn(i % 4 == 3 ? EnemySpawn::Kind::Koopa
+                             : EnemySpawn::Kind::Goomba,
+                  x, m_groundY);
+  }
+}
+
+bool StressLevelSpec::parse(const std::string &text, StressLevelSpec &spec) {
+  StressLevelSpec parsed;
+  double values[6] = {static_cast<double>(parsed.seed), parsed.width,
+                      static_cast<double>(parsed.enemies),
+                      static_cast<double>(parsed.platforms),
+                      static_cast<double>(parsed.hazards),
+                      static_cast<double>(parsed.blocks)};
+  std::stringstream stream(text);
+  std::string field;
+  int count = 0;
+  while (std::getline(stream, field, ',')) {
+    char *end = nullptr;
+    double value = std::strtod(field.c_str(), &end);
+    if (count >= 6 || field.empty() || *end != '\0' || value < 0.0) {
+      std::cerr << "Invalid stress level spec: " << text << std::endl;
+      return false;
+    }
+    values[count++] = value;
+  }
+  parsed.seed = static_cast<unsigned int>(values[0]);
+  parsed.width = std::max(MIN_WIDTH, static_cast<float>(values[1]));
+  parsed.enemies = static_cast<int>(values[2]);
+  parsed.platforms = static_cast<int>(values[3]);
+  parsed.hazards = static_cast<int>(values[4]);
+  parsed.blocks = static_cast<int>(values[5]);
+  spec = parsed;
+  return true;
+}
+
+std::string StressLevelSpec::toString() const {
+  std::ostringstream out;
+  // Enough digits for the width to round-trip exactly
+  out << seed << ',' << std::setprecision(9) << width << ',' << enemies
+      << ',' << platforms << ',' << hazards << ',' << blocks;
+  return out.str();
+}
+
 void Level::update(float dt) {
   // Update stomp cooldown
   if (m_stompCooldown > 0.0f) {
@@ -2131,10 +2204,15 @@ void Level::update(float dt) {
   for (auto &enemy : m_enemies) {
     enemy->update(dt);
   }
+  m_particles.update(dt);
 
-  // Update Fireballs
+  // Update Fireballs (destroyed once past the right end of the level)
   for (auto &fireball : m_fireballs) {
     fireball->update(dt);
+    if (fireball->isAlive() &&
+        fireball->getBounds().position.x > m_levelWidth + 200.0f) {
+      fireball->destroy();
+    }
   }
 
   // Check Fireball vs Enemy collisions
@@ -2152,11 +2230,14 @@ void Level::update(float dt) {
         if (koopa && koopa->isShell()) {
           // Kill shell with special animation
           koopa->killByFireball();
-          std::cout << "Fireball killed Koopa shell!" << std::endl;
+          m_particles.burst(ParticleSystem::Burst::Sparks,
+                            koopa->getPosition());
+          LEVEL_TRACE("Fireball killed Koopa shell!");
         } else {
           // Regular enemy - use stomp
           enemy->stomp();
-          std::cout << "Fireball hit enemy!" << std::endl;
+          m_particles.burst(ParticleSystem::Burst::Dust, enemy->getPosition());
+          LEVEL_TRACE("Fireball hit enemy!");
         }
         fireball->destroy();
         break;
@@ -2208,6 +2289,10 @@ void Level::checkCollisions(Player &player) {
       if (headRect.findIntersection(bBounds)) {
         // Trigger hit - only spawn item if first hit
         if (block.hit()) {
+          // Debris from the block's lower edge, where the head hit it
+          m_particles.burst(ParticleSystem::Burst::Debris,
+                            {block.getPosition().x,
+                             bBounds.position.y + bBounds.size.y});
           // Spawn Item based on block index and Mario's state
           // Block 0 = Mushroom only
           // Block 1+ = Fire Flower block (Mushroom if small, Fire Flower if
@@ -2238,7 +2323,8 @@ void Level::checkCollisions(Player &player) {
     if (!item->isCollected() && !item->isSpawning()) {
       if (player.getBounds().findIntersection(item->getBounds())) {
         item->collect();
-        m_powerupSound.play(); // Play powerup sound
+        sf::Vector2f itemPos = item->getBounds().getCenter();
+        pushEvent(m_events, GameEventType::Collect, itemPos.x, itemPos.y);
 
         // Check if it's a Fire Flower
         FireFlower *fireFlower = dynamic_cast<FireFlower *>(item.get());
@@ -2302,10 +2388,11 @@ void Level::checkCollisions(Player &player) {
       // Check Stomp Intersection First
       if (isFalling && pBounds.findIntersection(stompBox)) {
         enemy->stomp();
+        m_particles.burst(ParticleSystem::Burst::Dust, enemyPos);
         player.bounce();
         m_stompCooldown = STOMP_COOLDOWN_TIME;
-        m_stompSound.play(); // Play stomp sound
-        std::cout << "Enemy stomped (Strict Custom Hitbox)!" << std::endl;
+        pushEvent(m_events, GameEventType::Stomp, enemyPos.x, enemyPos.y);
+        LEVEL_TRACE("Enemy stomped (Strict Custom Hitbox)!");
         break;
       }
       // Check Damage Intersection Second
@@ -2317,7 +2404,7 @@ void Level::checkCollisions(Player &player) {
           float playerSpeed = std::abs(pVel.x);
           koopa->kick(kickDirection, playerSpeed);
           m_stompCooldown = STOMP_COOLDOWN_TIME;
-          std::cout << "Shell kicked!" << std::endl;
+          LEVEL_TRACE("Shell kicked!");
           break;
         } else {
           // Only take damage if touching the narrow "core" box
@@ -2331,76 +2418,383 @@ void Level::checkCollisions(Player &player) {
   if (!m_goal.isTriggered()) {
     if (player.getPosition().x >= m_goal.getX()) {
       m_goal.trigger();
-      m_goalSound.play();
-      std::cout << "Goal reached!" << std::endl;
+      pushEvent(m_events, GameEventType::Goal, m_goal.getX(), m_groundY);
+      LEVEL_TRACE("Goal reached!");
     }
   }
 }
 
-void Level::draw(sf::RenderWindow &window) {
-  // Dibujar Fondo (Repetir 4 veces para cubrir 6400px de ancho)
-  for (int i = 0; i < 4; ++i) {
-    m_bgSprite.setPosition(sf::Vector2f(i * 1600.0f, m_groundY - 750.0f));
-    window.draw(m_bgSprite);
-  }
+void Level::draw(sf::RenderTarget &target) {
+  // Dibujar Fondo (un quad por capa, del tamaño de la cámara)
+  m_background.draw(target);
 
   // Draw Corner Sprite (Spray)
-  window.draw(m_cornerSprite);
+  target.draw(m_cornerSprite);
   // CHECKER_SIZE removed
 
   // Calcular cuántas filas desde el suelo hacia arriba
   // CHECKERED BACKGROUND REMOVED
 
   // Dibujar suelo (sección normal con tilesets.png)
-  window.draw(m_groundVertices, &m_texture);
+  target.draw(m_groundVertices, &m_texture);
   // Dibujar suelo (sección alternativa con plataformas.png)
-  window.draw(m_groundVertices2, &m_texture2);
+  target.draw(m_groundVertices2, &m_texture2);
   // Dibujar suelo (tercera sección desde X=1216 con tilesets.png)
-  window.draw(m_groundVertices3, &m_texture);
+  target.draw(m_groundVertices3, &m_texture);
   // Dibujar suelo (cuarta sección desde X=4800 con tilesets.png)
-  window.draw(m_groundVertices4, &m_texture);
+  target.draw(m_groundVertices4, &m_texture);
 
   // Dibujar decoraciones de fondo
   for (auto &decoration : m_decorations) {
-    window.draw(decoration);
+    target.draw(decoration);
   }
 
   for (auto &block : m_blocks) {
-    block.draw(window);
+    block.draw(target);
   }
   for (auto &item : m_items) {
-    item->draw(window);
+    item->draw(target);
   }
   for (auto &enemy : m_enemies) {
-    enemy->draw(window);
+    enemy->draw(target);
   }
   for (auto &fireball : m_fireballs) {
-    fireball->draw(window);
+    fireball->draw(target);
   }
+  m_particles.draw(target);
 
   // Dibujar plataformas sólidas con textura
   for (auto &plat : m_platforms) {
-    window.draw(plat.vertices, &m_texture);
+    target.draw(plat.vertices, &m_texture);
   }
 
   // Draw Colored Platforms
   for (const auto &plat : m_coloredPlatforms) {
-    window.draw(plat);
+    target.draw(plat);
   }
 
   // Dibujar Bloques Asesinos
   for (const auto &kBlock : m_killBlocks) {
-    window.draw(kBlock.sprite);
+    target.draw(kBlock.sprite);
   }
 
   // SCREEN BOUNDARY MARKERS REMOVED
 
   // Draw Goal
-  m_goal.draw(window);
+  m_goal.draw(target);
+}
+
+void Level::buildStaticLayers() const {
+  // The capture area covers the whole level, so nothing is culled
+  sf::View area(sf::FloatRect({-m_width, -4.0f * m_height},
+                              {m_levelWidth + 2.0f * m_width, 8.0f * m_height}));
+
+  // Detrás de las entidades: esquina, suelo y decoraciones
+  auto back = std::make_shared<RenderSnapshot>();
+  back->camera = area;
+  back->addSprite(m_cornerSprite);
+  back->addTiles(m_groundVertices, &m_texture);
+  back->addTiles(m_groundVertices2, &m_texture2);
+  back->addTiles(m_groundVertices3, &m_texture);
+  back->addTiles(m_groundVertices4, &m_texture);
+  for (const auto &decoration : m_decorations) {
+    back->addSprite(decoration);
+  }
+
+  // Delante de las entidades: plataformas y bloques asesinos
+  auto front = std::make_shared<RenderSnapshot>();
+  front->camera = area;
+  for (const auto &plat : m_platforms) {
+    front->addTiles(plat.vertices, &m_texture);
+  }
+  for (const auto &plat : m_coloredPlatforms) {
+    front->addRectangle(plat);
+  }
+  for (const auto &kBlock : m_killBlocks) {
+    front->addSprite(kBlock.sprite);
+  }
+
+  m_staticBack = std::move(back);
+  m_staticFront = std::move(front);
+}
+
+void Level::snapshot(RenderSnapshot &snapshot) const {
+  // Mismo orden que draw()
+  m_background.snapshot(snapshot);
+  if (!m_staticBack) {
+    buildStaticLayers();
+  }
+  snapshot.addLayer(m_staticBack);
+
+  for (const auto &block : m_blocks) {
+    block.snapshot(snapshot);
+  }
+  for (const auto &item : m_items) {
+    item->snapshot(snapshot);
+  }
+  for (const auto &enemy : m_enemies) {
+    enemy->snapshot(snapshot);
+  }
+  for (const auto &fireball : m_fireballs) {
+    fireball->snapshot(snapshot);
+  }
+  snapshot.addTiles(m_particles.vertices(), nullptr);
+  snapshot.addLayer(m_staticFront);
+  m_goal.snapshot(snapshot);
+}
+
+void Level::addEnemySpawn(EnemySpawn::Kind kind, float x, float y,
+                          float direction) {
+  // Insert keeping the list sorted by x
+  auto pos = std::upper_bound(
+      m_enemySpawns.begin(), m_enemySpawns.end(), x,
+      [](float value, const EnemySpawn &spawn) { return value < spawn.x; });
+  m_enemySpawns.insert(pos, EnemySpawn{kind, x, y, direction});
+}
+
+std::unique_ptr<Enemy> Level::createEnemy(const EnemySpawn &spawn) {
+  std::unique_ptr<Enemy> enemy;
+  if (spawn.kind == EnemySpawn::Kind::Koopa) {
+    enemy = std::make_unique<Koopa>(m_physics, spawn.x, spawn.y);
+  } else {
+    enemy = std::make_unique<Goomba>(m_physics, spawn.x, spawn.y);
+  }
+  enemy->setDirection(spawn.direction);
+  return enemy;
+}
+
+void Level::spawnEnemy(EnemySpawn::Kind kind, float x, float y) {
+  m_enemies.push_back(createEnemy({kind, x, y}));
+}
+
+void Level::updateSpawns(float viewLeft, float viewRight) {
+  // Instantiate every record inside the activation window
+  auto first = std::lower_bound(
+      m_enemySpawns.begin(), m_enemySpawns.end(), viewLeft - SPAWN_MARGIN,
+      [](const EnemySpawn &spawn, float value) { return spawn.x < value; });
+  auto last = std::upper_bound(
+      first, m_enemySpawns.end(), viewRight + SPAWN_MARGIN,
+      [](float value, const EnemySpawn &spawn) { return value < spawn.x; });
+  for (auto it = first; it != last; ++it) {
+    m_enemies.push_back(createEnemy(*it));
+  }
+  m_enemySpawns.erase(first, last);
+
+  // Turn walking enemies far behind the camera back into records and
+  // drop idle Koopa shells there (they never resolve on their own).
+  // Stomped enemies and moving shells keep running until they resolve.
+  auto behind = std::stable_partition(
+      m_enemies.begin(), m_enemies.end(),
+      [&](const std::unique_ptr<Enemy> &e) {
+        if (!e->isAlive() || e->getPosition().x >= viewLeft - DESPAWN_DISTANCE) {
+          return true;
+        }
+        Koopa *koopa = dynamic_cast<Koopa *>(e.get());
+        return e->isStomped() && !(koopa && koopa->isIdleShell());
+      });
+  for (auto it = behind; it != m_enemies.end(); ++it) {
+    sf::Vector2f pos = (*it)->getPosition();
+    // Enemies that already fell out of the world, and idle shells, are
+    // simply dropped
+    if (pos.y > m_height || (*it)->isStomped()) {
+      continue;
+    }
+    EnemySpawn::Kind kind = dynamic_cast<Koopa *>(it->get())
+                                ? EnemySpawn::Kind::Koopa
+                                : EnemySpawn::Kind::Goomba;
+    addEnemySpawn(kind, pos.x, pos.y, (*it)->getDirection());
+  }
+  m_enemies.erase(behind, m_enemies.end());
 }
 
 void Level::spawnFireball(float x, float y, float direction) {
   m_fireballs.push_back(std::make_unique<Fireball>(m_physics, x, y, direction));
 }
 
-float Level::groundY() const { return m_groundY; }
\ No newline at end of file
+float Level::groundY() const { return m_groundY; }
+
+void Level::rasterize(float left, float top, float cellSize, int cols, int rows,
+                      std::uint8_t *out) const {
+  std::fill(out, out + cols * rows, static_cast<std::uint8_t>(Cell::Empty));
+
+  // Marks every cell overlapped by 'rect'; a cell keeps the highest kind
+  auto mark = [&](float x, float y, float w, float h, Cell cell) {
+    int c0 = std::max(0, static_cast<int>(std::floor((x - left) / cellSize)));
+    int c1 = std::min(cols - 1,
+                      static_cast<int>(std::ceil((x + w - left) / cellSize)) - 1);
+    int r0 = std::max(0, static_cast<int>(std::floor((y - top) / cellSize)));
+    int r1 = std::min(rows - 1,
+                      static_cast<int>(std::ceil((y + h - top) / cellSize)) - 1);
+    std::uint8_t value = static_cast<std::uint8_t>(cell);
+    for (int r = r0; r <= r1; ++r) {
+      for (int c = c0; c <= c1; ++c) {
+        out[r * cols + c] = std::max(out[r * cols + c], value);
+      }
+    }
+  };
+
+  for (const auto &rect : m_solidRects) {
+    mark(rect.position.x, rect.position.y, rect.size.x, rect.size.y, Cell::Solid);
+  }
+  for (const auto &plat : m_platforms) {
+    mark(plat.x, plat.y, plat.width, plat.height, Cell::Solid);
+  }
+  for (const auto &block : m_blocks) {
+    sf::FloatRect bounds = block.getBounds();
+    mark(bounds.position.x, bounds.position.y, bounds.size.x, bounds.size.y,
+         block.isActive() ? Cell::Block : Cell::Solid);
+  }
+  for (const auto &kb : m_killBlocks) {
+    mark(kb.x, kb.y, kb.width, kb.height, Cell::Hazard);
+  }
+}
+
+bool Level::isInsideSolid(sf::Vector2f point, float margin) const {
+  auto inside = [&](float x, float y, float w, float h) {
+    return point.x > x + margin && point.x < x + w - margin &&
+           point.y > y + margin && point.y < y + h - margin;
+  };
+
+  for (const auto &rect : m_solidRects) {
+    if (inside(rect.position.x, rect.position.y, rect.size.x, rect.size.y))
+      return true;
+  }
+  for (const auto &plat : m_platforms) {
+    if (inside(plat.x, plat.y, plat.width, plat.height))
+      return true;
+  }
+  for (const auto &block : m_blocks) {
+    sf::FloatRect bounds = block.getBounds();
+    if (inside(bounds.position.x, bounds.position.y, bounds.size.x,
+               bounds.size.y))
+      return true;
+  }
+  return false;
+}
+
+void Level::saveState(StateWriter &writer) const {
+  for (int section = 0; section < static_cast<int>(StateSection::Count);
+       ++section) {
+    saveSection(static_cast<StateSection>(section), writer);
+  }
+}
+
+void Level::saveSection(StateSection section, StateWriter &writer) const {
+  switch (section) {
+  case StateSection::Blocks:
+    writer.write<std::uint32_t>(static_cast<std::uint32_t>(m_blocks.size()));
+    for (const auto &block : m_blocks) {
+      block.saveState(writer);
+    }
+    break;
+
+  case StateSection::Items:
+    writer.write<std::uint32_t>(static_cast<std::uint32_t>(m_items.size()));
+    for (const auto &item : m_items) {
+      writer.write<std::uint8_t>(
+          dynamic_cast<const FireFlower *>(item.get()) ? 1 : 0);
+      item->saveState(writer);
+    }
+    break;
+
+  case StateSection::Enemies:
+    writer.write<std::uint32_t>(static_cast<std::uint32_t>(m_enemies.size()));
+    for (const auto &enemy : m_enemies) {
+      EnemySpawn::Kind kind = dynamic_cast<const Koopa *>(enemy.get())
+                                  ? EnemySpawn::Kind::Koopa
+                                  : EnemySpawn::Kind::Goomba;
+      writer.write(kind);
+      enemy->saveState(writer);
+    }
+    break;
+
+  case StateSection::Fireballs:
+    writer.write<std::uint32_t>(
+        static_cast<std::uint32_t>(m_fireballs.size()));
+    for (const auto &fireball : m_fireballs) {
+      fireball->saveState(writer);
+    }
+    break;
+
+  case StateSection::Spawns:
+    writer.write<std::uint32_t>(
+        static_cast<std::uint32_t>(m_enemySpawns.size()));
+    for (const auto &spawn : m_enemySpawns) {
+      writer.write(spawn.kind);
+      writer.write(spawn.x);
+      writer.write(spawn.y);
+      writer.write(spawn.direction);
+    }
+    break;
+
+  case StateSection::Goal:
+    m_goal.saveState(writer);
+    writer.write(m_stompCooldown);
+    break;
+
+  case StateSection::Count:
+    break;
+  }
+}
+
+bool Level::loadState(StateReader &reader) {
+  // Blocks are created by the constructor: only their state changes
+  std::uint32_t count = 0;
+  reader.read(count);
+  if (count != m_blocks.size()) {
+    std::cerr << "Error loading state: block count mismatch" << std::endl;
+    return false;
+  }
+  for (auto &block : m_blocks) {
+    block.loadState(reader);
+  }
+
+  // Runtime entities are rebuilt, then their saved state is applied
+  // (items/enemies/fireballs are few, so this stays in the microseconds)
+  reader.read(count);
+  m_items.clear();
+  for (std::uint32_t i = 0; i < count && reader.ok(); ++i) {
+    std::uint8_t isFlower = 0;
+    reader.read(isFlower);
+    if (isFlower) {
+      m_items.push_back(std::make_unique<FireFlower>(m_physics, 0.0f, 0.0f));
+    } else {
+      m_items.push_back(std::make_unique<Item>(m_physics, 0.0f, 0.0f));
+    }
+    m_items.back()->loadState(reader);
+  }
+
+  reader.read(count);
+  m_enemies.clear();
+  for (std::uint32_t i = 0; i < count && reader.ok(); ++i) {
+    EnemySpawn spawn{EnemySpawn::Kind::Goomba, 0.0f, 0.0f};
+    reader.read(spawn.kind);
+    m_enemies.push_back(createEnemy(spawn));
+    m_enemies.back()->loadState(reader);
+  }
+
+  reader.read(count);
+  m_fireballs.clear();
+  for (std::uint32_t i = 0; i < count && reader.ok(); ++i) {
+    m_fireballs.push_back(
+        std::make_unique<Fireball>(m_physics, 0.0f, 0.0f, 1.0f));
+    m_fireballs.back()->loadState(reader);
+  }
+
+  reader.read(count);
+  m_enemySpawns.clear();
+  for (std::uint32_t i = 0; i < count && reader.ok(); ++i) {
+    EnemySpawn spawn{EnemySpawn::Kind::Goomba, 0.0f, 0.0f};
+    reader.read(spawn.kind);
+    reader.read(spawn.x);
+    reader.read(spawn.y);
+    reader.read(spawn.direction);
+    m_enemySpawns.push_back(spawn);
+  }
+
+  m_goal.loadState(reader);
+  reader.read(m_stompCooldown);
+  // Not saved: effects of the abandoned timeline would linger
+  m_particles.clear();
+  return reader.ok();
+}
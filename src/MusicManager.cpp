@@ -0,0 +1,272 @@
+#include "MusicManager.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+const std::size_t CHUNK_FRAMES = 2048;  // ~46 ms per onGetData
+const std::size_t DECODE_FRAMES = 4096; // Read from the file at a time
+const std::size_t PREROLL_FRAMES = MusicManager::SAMPLE_RATE / 2;
+const float HALF_PI = 1.57079633f;
+const char* FALLBACK_TRACK = "assets/music/cumbia.MP3";
+} // namespace
+
+// One open file, read forward in blocks and looped without a gap.
+// Converted to stereo at SAMPLE_RATE (linear interpolation) while mixing.
+class MusicManager::Track {
+public:
+    bool open(const std::string& path) {
+        if (!m_file.openFromFile(path) || m_file.getChannelCount() == 0 ||
+            m_file.getSampleCount() == 0) {
+            return false;
+        }
+        m_channels = m_file.getChannelCount();
+        m_step = static_cast<double>(m_file.getSampleRate()) / SAMPLE_RATE;
+        return true;
+    }
+
+    // Decodes ahead so the first chunks need no file access
+    void preroll() {
+        while (bufferedFrames() < PREROLL_FRAMES * m_step && decodeMore()) {
+        }
+    }
+
+    // Adds 'frames' stereo frames scaled by gains[i] into 'out'
+    void mix(float* out, std::size_t frames, const float* gains) {
+        for (std::size_t i = 0; i < frames; ++i) {
+            std::size_t index = static_cast<std::size_t>(m_pos);
+            while (index + 1 >= bufferedFrames()) {
+                if (!decodeMore()) {
+                    return;
+                }
+            }
+            float t = static_cast<float>(m_pos - index);
+            const std::int16_t* a = &m_samples[index * m_channels];
+            const std::int16_t* b = a + m_channels;
+            float left = a[0] + (b[0] - a[0]) * t;
+            float right = m_channels > 1 ? a[1] + (b[1] - a[1]) * t : left;
+            out[i * 2] += left * gains[i];
+            out[i * 2 + 1] += right * gains[i];
+            m_pos += m_step;
+        }
+        // Drop what was consumed once it adds up
+        std::size_t consumed = static_cast<std::size_t>(m_pos);
+        if (consumed >= DECODE_FRAMES * 4) {
+            m_samples.erase(m_samples.begin(),
+                            m_samples.begin() + consumed * m_channels);
+            m_pos -= consumed;
+        }
+    }
+
+private:
+    std::size_t bufferedFrames() const { return m_samples.size() / m_channels; }
+
+    bool decodeMore() {
+        std::size_t start = m_samples.size();
+        m_samples.resize(start + DECODE_FRAMES * m_channels);
+        std::uint64_t read =
+            m_file.read(&m_samples[start], DECODE_FRAMES * m_channels);
+        if (read == 0) {
+            // End of the file: continue from the start (gapless loop)
+            m_file.seek(0);
+            read = m_file.read(&m_samples[start], DECODE_FRAMES * m_channels);
+        }
+        // Whole frames only
+        read -= read % m_channels;
+        m_samples.resize(start + static_cast<std::size_t>(read));
+        return read > 0;
+    }
+
+    sf::InputSoundFile m_file;
+    unsigned int m_channels = 1;
+    double m_step = 1.0; // Source frames per output frame
+    std::vector<std::int16_t> m_samples; // Interleaved, not yet consumed
+    double m_pos = 0.0; // Read position in m_samples (frames)
+};
+
+MusicManager::MusicManager()
+    : m_mix(CHUNK_FRAMES * 2)
+    , m_gainOut(CHUNK_FRAMES)
+    , m_gainIn(CHUNK_FRAMES)
+    , m_output(CHUNK_FRAMES * 2)
+{
+    initialize(2, SAMPLE_RATE,
+               {sf::SoundChannel::FrontLeft, sf::SoundChannel::FrontRight});
+    m_worker = std::thread(&MusicManager::workerLoop, this);
+    // Runs for the whole program (silence until play())
+    sf::SoundStream::play();
+}
+
+MusicManager::~MusicManager() {
+    // Stop the stream before its tracks go away
+    sf::SoundStream::stop();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_one();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+std::string MusicManager::levelTrackPath(int level) {
+    // Only a directory lookup: the file is opened by the worker
+    std::string base = "assets/music/nivel" + std::to_string(level);
+    for (const std::string& path : {base + ".ogg", base + ".mp3"}) {
+        std::error_code error;
+        if (std::filesystem::is_regular_file(path, error)) {
+            return path;
+        }
+    }
+    return FALLBACK_TRACK;
+}
+
+void MusicManager::requestOpen(const std::string& path) {
+    if (path == m_currentPath || path == m_nextPath || m_ready.count(path) ||
+        std::find(m_opening.begin(), m_opening.end(), path) != m_opening.end()) {
+        return;
+    }
+    m_opening.push_back(path);
+    m_toOpen.push_back(path);
+    m_wake.notify_one();
+}
+
+void MusicManager::prefetch(int level) {
+    std::string path = levelTrackPath(level);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    requestOpen(path);
+}
+
+void MusicManager::play(int level, float fadeSeconds) {
+    std::string path = levelTrackPath(level);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_wanted = path;
+    m_wantedFade = fadeSeconds;
+    requestOpen(path);
+}
+
+void MusicManager::stop(float fadeSeconds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_wanted.clear();
+    m_wantedFade = fadeSeconds;
+}
+
+void MusicManager::workerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this] { return m_quit || !m_toOpen.empty(); });
+        if (m_quit) {
+            return;
+        }
+        std::string path = m_toOpen.front();
+        m_toOpen.pop_front();
+
+        // Open and pre-decode without holding the lock
+        lock.unlock();
+        auto track = std::make_unique<Track>();
+        bool opened = track->open(path);
+        if (opened) {
+            track->preroll();
+        } else {
+            std::cerr << "Error loading music " << path << std::endl;
+        }
+        lock.lock();
+
+        m_opening.erase(std::find(m_opening.begin(), m_opening.end(), path));
+        if (opened) {
+            m_ready[path] = std::move(track);
+        }
+    }
+}
+
+void MusicManager::applyRequest() {
+    // Tracks opened by the worker are picked up here; destroying replaced
+    // ones (closing files) happens after the lock is released
+    std::unique_ptr<Track> dropped;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool fading = m_fadeDone < m_fadeFrames;
+    if (m_wanted == (fading ? m_nextPath : m_currentPath)) {
+        return;
+    }
+    if (fading && m_wanted == m_currentPath) {
+        // Back to what was fading out: reverse the fade from where it is
+        std::swap(m_current, m_next);
+        std::swap(m_currentPath, m_nextPath);
+        m_fadeDone = m_fadeFrames - m_fadeDone;
+        return;
+    }
+
+    std::unique_ptr<Track> incoming;
+    if (!m_wanted.empty()) {
+        auto it = m_ready.find(m_wanted);
+        if (it == m_ready.end()) {
+            return; // Still opening: keep playing what we have
+        }
+        incoming = std::move(it->second);
+        m_ready.erase(it);
+    }
+
+    // A fade already running is cut short; the louder side fades out
+    if (fading && m_fadeDone * 2 >= m_fadeFrames) {
+        dropped = std::move(m_current);
+        m_current = std::move(m_next);
+        m_currentPath = m_nextPath;
+    } else {
+        dropped = std::move(m_next);
+    }
+    m_next = std::move(incoming);
+    m_nextPath = m_wanted;
+    m_fadeFrames = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::lround(m_wantedFade * SAMPLE_RATE)));
+    m_fadeDone = 0;
+}
+
+bool MusicManager::onGetData(Chunk& data) {
+    applyRequest();
+
+    // Gains of this chunk, one per frame (sample-accurate fade)
+    for (std::size_t i = 0; i < CHUNK_FRAMES; ++i) {
+        float t = 1.0f;
+        if (m_fadeDone + i < m_fadeFrames) {
+            t = static_cast<float>(m_fadeDone + i) / m_fadeFrames;
+        }
+        m_gainOut[i] = std::cos(t * HALF_PI);
+        m_gainIn[i] = std::sin(t * HALF_PI);
+    }
+    bool fading = m_fadeDone < m_fadeFrames;
+
+    std::fill(m_mix.begin(), m_mix.end(), 0.0f);
+    if (m_current) {
+        m_current->mix(m_mix.data(), CHUNK_FRAMES,
+                       fading ? m_gainOut.data() : m_gainIn.data());
+    }
+    if (fading && m_next) {
+        m_next->mix(m_mix.data(), CHUNK_FRAMES, m_gainIn.data());
+    }
+
+    if (fading) {
+        m_fadeDone = std::min(m_fadeFrames, m_fadeDone + CHUNK_FRAMES);
+        if (m_fadeDone == m_fadeFrames) {
+            // The incoming track (or silence) takes over
+            std::unique_ptr<Track> dropped = std::move(m_current);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_current = std::move(m_next);
+            m_currentPath = m_nextPath;
+            m_nextPath.clear();
+        }
+    }
+
+    for (std::size_t i = 0; i < m_mix.size(); ++i) {
+        m_output[i] = static_cast<std::int16_t>(
+            std::clamp(m_mix[i], -32768.0f, 32767.0f));
+    }
+    data.samples = m_output.data();
+    data.sampleCount = m_output.size();
+    return true; // Never ends: silence between tracks
+}
+
+void MusicManager::onSeek(sf::Time) {
+    // Not seekable: the position belongs to the tracks
+}
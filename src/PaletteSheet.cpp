@@ -0,0 +1,203 @@
+#include "PaletteSheet.hpp"
+#include "TextureCache.hpp"
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+const unsigned int PALETTE_WIDTH = 256;
+// Two index bytes per pixel (extra colours fall back to the first one)
+const std::size_t MAX_COLORS = PALETTE_WIDTH * PALETTE_WIDTH;
+
+// Index in red (low byte) and green (high byte) of the index texture
+const char* PALETTE_SHADER = R"(
+uniform sampler2D texture;
+uniform sampler2D palette;
+uniform vec2 paletteSize;
+uniform float firstRow;
+
+void main() {
+    vec4 index = texture2D(texture, gl_TexCoord[0].xy);
+    float column = floor(index.r * 255.0 + 0.5);
+    float row = firstRow + floor(index.g * 255.0 + 0.5);
+    vec4 color = texture2D(palette, vec2((column + 0.5) / paletteSize.x,
+                                         (row + 0.5) / paletteSize.y));
+    gl_FragColor = vec4(color.rgb, index.a) * gl_Color;
+}
+)";
+
+// Shared by every sheet; loaded on first use by the render thread.
+// nullptr when shaders are not available.
+sf::Shader* paletteShader() {
+    static std::unique_ptr<sf::Shader> shader;
+    static bool tried = false;
+    if (!tried) {
+        tried = true;
+        auto loaded = std::make_unique<sf::Shader>();
+        if (!sf::Shader::isAvailable()) {
+            std::cerr << "Shaders not available: palette variants are recoloured on the CPU" << std::endl;
+        } else if (!loaded->loadFromMemory(PALETTE_SHADER, sf::Shader::Type::Fragment)) {
+            std::cerr << "Error loading the palette shader" << std::endl;
+        } else {
+            shader = std::move(loaded);
+        }
+    }
+    return shader.get();
+}
+
+std::uint32_t rgbKey(sf::Color color) {
+    return (std::uint32_t(color.r) << 16) | (std::uint32_t(color.g) << 8) | color.b;
+}
+
+} // namespace
+
+PaletteSheet& PaletteSheet::get(const std::string& path) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::unique_ptr<PaletteSheet>> sheets;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = sheets.find(path);
+    if (it != sheets.end()) {
+        return *it->second;
+    }
+
+    sf::Image image;
+    if (!TextureCache::isHeadless() && !image.loadFromFile(path)) {
+        std::cerr << "Error loading " << path << std::endl;
+    }
+    auto sheet = std::make_unique<PaletteSheet>(image);
+    return *sheets.emplace(path, std::move(sheet)).first->second;
+}
+
+PaletteSheet::PaletteSheet(const sf::Image& image) {
+    sf::Vector2u size = image.getSize();
+    if (size.x == 0 || size.y == 0) {
+        return; // Headless or failed load: nothing to draw
+    }
+
+    // Number every distinct colour (alpha is kept per pixel)
+    std::unordered_map<std::uint32_t, unsigned int> indexOf;
+    sf::Image indices(size);
+    for (unsigned int y = 0; y < size.y; ++y) {
+        for (unsigned int x = 0; x < size.x; ++x) {
+            sf::Color color = image.getPixel({x, y});
+            if (color.a == 0) {
+                indices.setPixel({x, y}, sf::Color::Transparent);
+                continue;
+            }
+            unsigned int index = 0;
+            auto found = indexOf.find(rgbKey(color));
+            if (found != indexOf.end()) {
+                index = found->second;
+            } else if (m_colors.size() < MAX_COLORS) {
+                index = static_cast<unsigned int>(m_colors.size());
+                indexOf.emplace(rgbKey(color), index);
+                m_colors.push_back(sf::Color(color.r, color.g, color.b));
+            }
+            indices.setPixel({x, y}, sf::Color(index % PALETTE_WIDTH,
+                                               index / PALETTE_WIDTH, 0, color.a));
+        }
+    }
+    if (!m_indexTexture.loadFromImage(indices)) {
+        std::cerr << "Error creating a palette index texture" << std::endl;
+    }
+
+    m_rowsPerVariant = std::max(1u, static_cast<unsigned int>(
+        (m_colors.size() + PALETTE_WIDTH - 1) / PALETTE_WIDTH));
+    addVariant([](sf::Color color) { return color; });
+}
+
+int PaletteSheet::variantCount() const {
+    return m_rowsPerVariant ? m_palette.getSize().y / m_rowsPerVariant : 0;
+}
+
+int PaletteSheet::addVariant(const std::function<sf::Color(sf::Color)>& recolor) {
+    if (m_rowsPerVariant == 0) {
+        return 0; // Empty sheet
+    }
+    int variant = variantCount();
+    sf::Image palette({PALETTE_WIDTH, (variant + 1) * m_rowsPerVariant});
+    if (variant > 0 && !palette.copy(m_palette, {0, 0})) {
+        std::cerr << "Error growing a palette" << std::endl;
+    }
+    for (std::size_t i = 0; i < m_colors.size(); ++i) {
+        sf::Color color = recolor(m_colors[i]);
+        color.a = 255;
+        palette.setPixel({static_cast<unsigned int>(i % PALETTE_WIDTH),
+                          static_cast<unsigned int>(variant * m_rowsPerVariant +
+                                                    i / PALETTE_WIDTH)},
+                         color);
+    }
+    m_palette = palette;
+    if (!m_paletteTexture.loadFromImage(m_palette)) {
+        std::cerr << "Error creating a palette texture" << std::endl;
+    }
+    return variant;
+}
+
+const sf::Texture& PaletteSheet::fallbackTexture(int variant) const {
+    std::lock_guard<std::mutex> lock(m_fallbackMutex);
+    if (m_fallback.size() <= static_cast<std::size_t>(variant)) {
+        m_fallback.resize(variant + 1);
+    }
+    if (!m_fallback[variant]) {
+        // Same layout as the index texture, colours looked up once. The
+        // indices are read back from the GPU only here (render thread).
+        sf::Image indices = m_indexTexture.copyToImage();
+        sf::Image image(indices.getSize(), sf::Color::Transparent);
+        for (unsigned int y = 0; y < image.getSize().y; ++y) {
+            for (unsigned int x = 0; x < image.getSize().x; ++x) {
+                sf::Color index = indices.getPixel({x, y});
+                if (index.a == 0) {
+                    continue;
+                }
+                sf::Color color = m_palette.getPixel(
+                    {index.r, variant * m_rowsPerVariant + index.g});
+                color.a = index.a;
+                image.setPixel({x, y}, color);
+            }
+        }
+        m_fallback[variant] = std::make_unique<sf::Texture>();
+        if (!m_fallback[variant]->loadFromImage(image)) {
+            std::cerr << "Error creating a recoloured texture" << std::endl;
+        }
+    }
+    return *m_fallback[variant];
+}
+
+void PaletteSheet::apply(sf::RenderStates& states, int variant) const {
+    if (variant < 0 || variant >= variantCount()) {
+        variant = 0;
+    }
+    if (m_rowsPerVariant == 0) {
+        states.texture = &m_indexTexture; // Empty sheet
+        return;
+    }
+    sf::Shader* shader = paletteShader();
+    if (!shader) {
+        states.texture = &fallbackTexture(variant);
+        return;
+    }
+    shader->setUniform("texture", sf::Shader::CurrentTexture);
+    shader->setUniform("palette", m_paletteTexture);
+    shader->setUniform("paletteSize",
+                       sf::Glsl::Vec2(static_cast<float>(m_palette.getSize().x),
+                                      static_cast<float>(m_palette.getSize().y)));
+    shader->setUniform("firstRow", static_cast<float>(variant * m_rowsPerVariant));
+    states.texture = &m_indexTexture;
+    states.shader = shader;
+}
+
+void PaletteSheet::draw(sf::RenderTarget& target, const sf::Sprite& sprite,
+                        int variant) const {
+    sf::RenderStates states;
+    apply(states, variant);
+    if (states.texture == &m_indexTexture) {
+        target.draw(sprite, states);
+        return;
+    }
+    // Fallback: the same sprite on the recoloured texture
+    sf::Sprite recoloured(sprite);
+    recoloured.setTexture(*states.texture);
+    target.draw(recoloured, states);
+}
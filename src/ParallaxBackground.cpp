@@ -0,0 +1,61 @@
+#include "ParallaxBackground.hpp"
+#include <algorithm>
+
+void ParallaxBackground::addLayer(const sf::Texture& texture, float top,
+                                  float height, float scrollFactor) {
+    m_layers.push_back({&texture, top, height, scrollFactor});
+}
+
+bool ParallaxBackground::layerQuad(const Layer& layer, const sf::View& view,
+                                   sf::Vertex (&quad)[4]) const {
+    sf::Vector2u texSize = layer.texture->getSize();
+    if (texSize.x == 0 || texSize.y == 0) {
+        return false; // Headless or failed load
+    }
+    sf::Vector2f viewSize = view.getSize();
+    float left = view.getCenter().x - viewSize.x / 2.0f;
+    float viewTop = view.getCenter().y - viewSize.y / 2.0f;
+
+    // Only the visible rows of the layer
+    float top = std::max(layer.top, viewTop);
+    float bottom = std::min(layer.top + layer.height, viewTop + viewSize.y);
+    if (bottom <= top) {
+        return false;
+    }
+
+    // World px -> texture px; the texture repeats past its width
+    float scale = texSize.y / layer.height;
+    float u0 = left * layer.scrollFactor * scale;
+    float u1 = u0 + viewSize.x * scale;
+    float v0 = (top - layer.top) * scale;
+    float v1 = (bottom - layer.top) * scale;
+
+    quad[0].position = {left, top};
+    quad[0].texCoords = {u0, v0};
+    quad[1].position = {left + viewSize.x, top};
+    quad[1].texCoords = {u1, v0};
+    quad[2].position = {left, bottom};
+    quad[2].texCoords = {u0, v1};
+    quad[3].position = {left + viewSize.x, bottom};
+    quad[3].texCoords = {u1, v1};
+    return true;
+}
+
+void ParallaxBackground::draw(sf::RenderTarget& target) const {
+    sf::Vertex quad[4];
+    for (const Layer& layer : m_layers) {
+        if (layerQuad(layer, target.getView(), quad)) {
+            target.draw(quad, 4, sf::PrimitiveType::TriangleStrip,
+                        sf::RenderStates(layer.texture));
+        }
+    }
+}
+
+void ParallaxBackground::snapshot(RenderSnapshot& snapshot) const {
+    sf::Vertex quad[4];
+    for (const Layer& layer : m_layers) {
+        if (layerQuad(layer, snapshot.camera, quad)) {
+            snapshot.addQuad(quad, layer.texture);
+        }
+    }
+}
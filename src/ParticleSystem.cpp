@@ -0,0 +1,161 @@
+#include "ParticleSystem.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+struct BurstStyle {
+    int count;
+    float minSpeed, maxSpeed; // px/s
+    float minAngle, maxAngle; // Degrees, 0 = right, -90 = up
+    float gravity;            // px/s^2
+    float life;               // s
+    sf::Color color;
+    float size; // Side of the square (px)
+};
+
+// Indexed by ParticleSystem::Burst
+const BurstStyle STYLES[] = {
+    {8, 40.0f, 90.0f, -180.0f, 0.0f, 150.0f, 0.35f, sf::Color(200, 200, 200), 4.0f},
+    {6, 120.0f, 220.0f, -150.0f, -30.0f, 900.0f, 0.7f, sf::Color(200, 76, 12), 6.0f},
+    {12, 80.0f, 200.0f, -180.0f, 180.0f, 300.0f, 0.45f, sf::Color(255, 200, 40), 3.0f},
+    {20, 100.0f, 260.0f, -180.0f, 180.0f, 400.0f, 0.9f, sf::Color(228, 52, 52), 5.0f},
+};
+static_assert(sizeof(STYLES) / sizeof(STYLES[0]) ==
+                  static_cast<std::size_t>(ParticleSystem::Burst::Count),
+              "one style per burst");
+
+const float DEG_TO_RAD = 3.14159265f / 180.0f;
+
+} // namespace
+
+ParticleSystem::ParticleSystem(std::size_t capacity)
+    : m_x(capacity), m_y(capacity), m_vx(capacity), m_vy(capacity),
+      m_ay(capacity), m_life(capacity), m_invLife(capacity), m_frame(capacity),
+      m_vertices(sf::PrimitiveType::Triangles) {}
+
+float ParticleSystem::random(float low, float high) {
+    // xorshift32: cheap and the same sequence on every run
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+    return low + (high - low) * static_cast<float>(m_seed >> 8) / 16777216.0f;
+}
+
+bool ParticleSystem::emit(sf::Vector2f position, sf::Vector2f velocity,
+                          float gravity, float life, Burst frame) {
+    // Count is the number of looks, not one of them
+    assert(frame < Burst::Count);
+    if (m_count == capacity() || life <= 0.0f || frame >= Burst::Count) {
+        return false;
+    }
+    std::size_t i = m_count++;
+    m_x[i] = position.x;
+    m_y[i] = position.y;
+    m_vx[i] = velocity.x;
+    m_vy[i] = velocity.y;
+    m_ay[i] = gravity;
+    m_life[i] = life;
+    m_invLife[i] = 1.0f / life;
+    m_frame[i] = static_cast<std::uint8_t>(frame);
+    m_dirty = true;
+    return true;
+}
+
+std::size_t ParticleSystem::burst(Burst kind, sf::Vector2f position) {
+    assert(kind < Burst::Count);
+    if (kind >= Burst::Count) {
+        return 0;
+    }
+    const BurstStyle& style = STYLES[static_cast<std::size_t>(kind)];
+    std::size_t emitted = 0;
+    for (int i = 0; i < style.count; ++i) {
+        float angle = random(style.minAngle, style.maxAngle) * DEG_TO_RAD;
+        float speed = random(style.minSpeed, style.maxSpeed);
+        // Slightly different lifetimes so the burst does not vanish at once
+        float life = style.life * random(0.75f, 1.0f);
+        if (!emit(position, {std::cos(angle) * speed, std::sin(angle) * speed},
+                  style.gravity, life, kind)) {
+            break;
+        }
+        ++emitted;
+    }
+    return emitted;
+}
+
+void ParticleSystem::update(float dt) {
+    const std::size_t n = m_count;
+    float* __restrict x = m_x.data();
+    float* __restrict y = m_y.data();
+    float* __restrict vx = m_vx.data();
+    float* __restrict vy = m_vy.data();
+    const float* __restrict ay = m_ay.data();
+    float* __restrict life = m_life.data();
+
+    // Integration: no branches and no dependencies between particles
+    for (std::size_t i = 0; i < n; ++i) {
+        vy[i] += ay[i] * dt;
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        life[i] -= dt;
+    }
+
+    // Swap-remove the dead ones (a few per tick at most)
+    for (std::size_t i = 0; i < m_count;) {
+        if (m_life[i] > 0.0f) {
+            ++i;
+            continue;
+        }
+        std::size_t last = --m_count;
+        m_x[i] = m_x[last];
+        m_y[i] = m_y[last];
+        m_vx[i] = m_vx[last];
+        m_vy[i] = m_vy[last];
+        m_ay[i] = m_ay[last];
+        m_life[i] = m_life[last];
+        m_invLife[i] = m_invLife[last];
+        m_frame[i] = m_frame[last];
+    }
+    m_dirty = true;
+}
+
+void ParticleSystem::clear() {
+    m_count = 0;
+    m_dirty = true;
+}
+
+const sf::VertexArray& ParticleSystem::vertices() const {
+    if (!m_dirty) {
+        return m_vertices;
+    }
+    m_vertices.resize(m_count * 6);
+    for (std::size_t i = 0; i < m_count; ++i) {
+        const BurstStyle& style = STYLES[m_frame[i]];
+        float half = style.size / 2.0f;
+        float left = m_x[i] - half;
+        float right = m_x[i] + half;
+        float top = m_y[i] - half;
+        float bottom = m_y[i] + half;
+        // Fades out over its life
+        sf::Color color = style.color;
+        color.a = static_cast<std::uint8_t>(
+            255.0f * std::min(1.0f, m_life[i] * m_invLife[i]));
+
+        sf::Vertex* quad = &m_vertices[i * 6];
+        quad[0] = {{left, top}, color};
+        quad[1] = {{right, top}, color};
+        quad[2] = {{left, bottom}, color};
+        quad[3] = {{left, bottom}, color};
+        quad[4] = {{right, top}, color};
+        quad[5] = {{right, bottom}, color};
+    }
+    m_dirty = false;
+    return m_vertices;
+}
+
+void ParticleSystem::draw(sf::RenderTarget& target) const {
+    if (m_count > 0) {
+        target.draw(vertices());
+    }
+}
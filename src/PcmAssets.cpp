@@ -0,0 +1,107 @@
+#include "PcmAssets.hpp"
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace {
+const char MAGIC[4] = {'M', 'P', 'C', 'M'};
+const std::uint16_t VERSION = 1;
+const std::size_t HEADER_SIZE = 20; // Up to the channel map
+
+std::size_t samplesOffset(unsigned int channels) {
+    return (HEADER_SIZE + channels + 7) / 8 * 8;
+}
+
+template <typename T>
+T readAt(const std::uint8_t* data, std::size_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void append(std::vector<char>& out, T value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+} // namespace
+
+const std::vector<PcmAsset>& PcmAsset::all() {
+    static const std::vector<PcmAsset> assets = {
+        {"aplastar", "assets/music/aplastar.mp3"},
+        {"powerup", "assets/music/powerup.wav"},
+        {"goal_sound", "assets/music/goal_sound.wav"},
+        {"muerte", "assets/music/muerte.wav"},
+        {"jump", "assets/music/jump.ogg"},
+        {"menu_sound", "assets/music/menu_sound.wav"},
+    };
+    return assets;
+}
+
+const PcmAsset* PcmAsset::findSource(const std::string& source) {
+    for (const PcmAsset& asset : all()) {
+        if (source == asset.source) {
+            return &asset;
+        }
+    }
+    return nullptr;
+}
+
+std::string PcmAsset::path() const {
+    return std::string("assets/pcm/") + name + ".pcm";
+}
+
+bool PcmAsset::write(const std::string& path, const sf::SoundBuffer& buffer) {
+    std::vector<sf::SoundChannel> channelMap = buffer.getChannelMap();
+    unsigned int channels = buffer.getChannelCount();
+    if (channels == 0 || channelMap.size() != channels) {
+        return false;
+    }
+
+    std::vector<char> header;
+    header.insert(header.end(), MAGIC, MAGIC + 4);
+    append<std::uint16_t>(header, VERSION);
+    append<std::uint16_t>(header, static_cast<std::uint16_t>(channels));
+    append<std::uint32_t>(header, buffer.getSampleRate());
+    append<std::uint64_t>(header, buffer.getSampleCount());
+    for (sf::SoundChannel channel : channelMap) {
+        header.push_back(static_cast<char>(channel));
+    }
+    header.resize(samplesOffset(channels), 0);
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file.write(reinterpret_cast<const char*>(buffer.getSamples()),
+               static_cast<std::streamsize>(buffer.getSampleCount() *
+                                            sizeof(std::int16_t)));
+    return static_cast<bool>(file);
+}
+
+bool PcmAsset::load(const std::string& path, sf::SoundBuffer& buffer) {
+    MappedFile file;
+    if (!file.open(path) || file.size() < HEADER_SIZE ||
+        std::memcmp(file.data(), MAGIC, 4) != 0 ||
+        readAt<std::uint16_t>(file.data(), 4) != VERSION) {
+        return false;
+    }
+    unsigned int channels = readAt<std::uint16_t>(file.data(), 6);
+    unsigned int sampleRate = readAt<std::uint32_t>(file.data(), 8);
+    std::uint64_t sampleCount = readAt<std::uint64_t>(file.data(), 12);
+    std::size_t offset = samplesOffset(channels);
+    if (channels == 0 || file.size() < offset ||
+        sampleCount > (file.size() - offset) / sizeof(std::int16_t)) {
+        return false;
+    }
+
+    std::vector<sf::SoundChannel> channelMap;
+    for (unsigned int c = 0; c < channels; ++c) {
+        channelMap.push_back(
+            static_cast<sf::SoundChannel>(file.data()[HEADER_SIZE + c]));
+    }
+    // The samples start 8-byte aligned in a page-aligned mapping
+    const auto* samples =
+        reinterpret_cast<const std::int16_t*>(file.data() + offset);
+    return buffer.loadFromSamples(samples, sampleCount, channels, sampleRate,
+                                  channelMap);
+}
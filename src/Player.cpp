@@ -1,41 +1,26 @@
 #include "Player.hpp"
-#include <SFML/Window/Keyboard.hpp>
+#include "SpriteSync.hpp"
+#include "StateBuffer.hpp"
 #include <cmath> // Para std::abs
 #include <iostream>
 
-Player::Player(Physics &physics, float startX, float startY)
-    : m_physics(physics), m_sprite(m_texture), m_width(32.0f), m_height(32.0f),
+Player::Player(Physics &physics, float startX, float startY,
+               GameEventQueue *events)
+    : m_physics(physics), m_bodyId(b2_nullBodyId),
+      m_smallSheet(PaletteSheet::get("assets/images/mario_chiquito.png")),
+      m_bigSheet(PaletteSheet::get("assets/images/mario_grande.png")),
+      m_fireSheet(PaletteSheet::get("assets/images/mario_fuego.png")),
+      m_texture(m_smallSheet.indexTexture()),
+      m_bigTexture(m_bigSheet.indexTexture()),
+      m_fireTexture(m_fireSheet.indexTexture()),
+      m_sprite(m_texture), m_width(32.0f), m_height(32.0f),
       m_canJump(false), m_isBig(false), m_isFireMario(false), m_isDead(false),
-      m_isInvulnerable(false), m_invulnerableTimer(0.0f),
+      m_isInvulnerable(false), m_invulnerableTimer(0.0f), m_frozen(false),
       m_animationTimer(0.0f), m_groundTimer(0.0f), m_runTimer(0.0f),
       m_currentFrame(0), m_facingRight(true), m_state(State::Idle),
       m_fireballCooldown(0.0f), m_throwTimer(0.0f), m_isThrowing(false),
-      m_deathSound(m_deathSoundBuffer), m_frozen(false), m_jumpSound(m_jumpSoundBuffer) {
+      m_events(events) {
   // ... (Constructor content unchanged) ...
-  // Load Texture
-  if (!m_texture.loadFromFile("assets/images/mario_chiquito.png")) {
-    std::cerr << "Error loading mario_chiquito.png" << std::endl;
-    // Handle error? For now just continue, sprite will be white
-  }
-  if (!m_bigTexture.loadFromFile("assets/images/mario_grande.png")) {
-    std::cerr << "Error loading mario_grande.png" << std::endl;
-  }
-  if (!m_fireTexture.loadFromFile("assets/images/mario_fuego.png")) {
-    std::cerr << "Error loading mario_fuego.png" << std::endl;
-  }
-  
-  // Load Death Sound
-  if (!m_deathSoundBuffer.loadFromFile("assets/music/muerte.wav")) {
-    std::cerr << "Error loading muerte.wav" << std::endl;
-  }
-  
-  // Load Jump Sound
-  if (!m_jumpSoundBuffer.loadFromFile("assets/music/jump.ogg")) {
-    std::cerr << "Error loading jump.ogg" << std::endl;
-  }
-  
-  m_sprite.setTexture(m_texture);
-
   // Set initial frame (Idle = 0)
   // Precise cutout: (0, 2), 17x25
   m_sprite.setTextureRect(sf::IntRect({0, 2}, {17, 25}));
@@ -50,31 +35,49 @@ Player::Player(Physics &physics, float startX, float startY)
   m_sprite.setScale({2.5f, 2.5f});
 
   // Definición del cuerpo (v3)
+  createBody(BodyShape::Small,
+             (b2Vec2){startX / Physics::SCALE, startY / Physics::SCALE},
+             (b2Vec2){0.0f, 0.0f});
+}
+
+void Player::createBody(BodyShape shape, b2Vec2 position, b2Vec2 velocity) {
+  if (b2Body_IsValid(m_bodyId)) {
+    b2DestroyBody(m_bodyId);
+  }
+
   b2BodyDef bodyDef = b2DefaultBodyDef();
   bodyDef.type = b2_dynamicBody;
-  bodyDef.position = (b2Vec2){startX / Physics::SCALE, startY / Physics::SCALE};
+  bodyDef.position = position;
   bodyDef.fixedRotation = true;
 
   // Crear el cuerpo usando el ID del mundo
   m_bodyId = b2CreateBody(m_physics.worldId(), &bodyDef);
+  m_bodyShape = shape;
 
   // Definir la forma (Caja)
-  // Use slightly adjusting sizing for physics if we want it to match sprite
-  // better But keeping original 32x48 for now to avoid breaking existing level
-  // collisions
-  b2Polygon dynamicBox = b2MakeBox((m_width / 2.0f) / Physics::SCALE,
-                                   (m_height / 2.0f) / Physics::SCALE);
+  // Small: original 32x32 box. Big: 28x52 to better match the sprite.
+  b2Polygon box = (shape == BodyShape::Big)
+                      ? b2MakeBox((BIG_BODY_WIDTH / 2.0f) / Physics::SCALE,
+                                  (BIG_BODY_HEIGHT / 2.0f) / Physics::SCALE)
+                      : b2MakeBox((m_width / 2.0f) / Physics::SCALE,
+                                  (m_height / 2.0f) / Physics::SCALE);
 
   // Definir la "fixture" (propiedades físicas)
   b2ShapeDef shapeDef = b2DefaultShapeDef();
   shapeDef.density = 1.0f;
   // shapeDef.friction = 0.3f;
+  if (shape == BodyShape::Dead) {
+    shapeDef.filter.categoryBits = 0; // Collide with nothing
+    shapeDef.filter.maskBits = 0;
+  }
 
   // Unir forma al cuerpo
-  b2CreatePolygonShape(m_bodyId, &shapeDef, &dynamicBox);
+  b2CreatePolygonShape(m_bodyId, &shapeDef, &box);
+
+  b2Body_SetLinearVelocity(m_bodyId, velocity);
 }
 
-void Player::handleInput(float dt) {
+void Player::handleInput(float dt, InputState input) {
   if (m_isDead || m_frozen)
     return;
 
@@ -89,12 +92,9 @@ void Player::handleInput(float dt) {
 
   // Input Handling
   bool isMoving = false;
-  bool leftInput = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left) ||
-                   sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A);
-  bool rightInput = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right) ||
-                    sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D);
-  bool downInput = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down) ||
-                   sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S);
+  bool leftInput = input.held(InputState::Left);
+  bool rightInput = input.held(InputState::Right);
+  bool downInput = input.held(InputState::Down);
   bool isSkidding = false;
   bool isCrouching = downInput && m_isBig &&
                      m_canJump; // Crouch only if Big Mario and on ground
@@ -169,17 +169,18 @@ void Player::handleInput(float dt) {
   b2Body_ApplyLinearImpulseToCenter(m_bodyId, (b2Vec2){impulse, 0.0f}, true);
 
   // Salto - SOLO con Up (Space ahora es para fuego)
-  if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up) && m_canJump) {
+  if (input.held(InputState::Jump) && m_canJump) {
     float jumpImpulse = -b2Body_GetMass(m_bodyId) * 13.0f;
     b2Body_ApplyLinearImpulseToCenter(m_bodyId, (b2Vec2){0.0f, jumpImpulse},
                                       true);
     m_canJump = false;
     m_state = State::Jumping;
-    m_jumpSound.play(); // Play jump sound
+    pushEvent(m_events, GameEventType::Jump, getPosition().x,
+              getPosition().y);
   }
 }
 
-void Player::update(float dt) {
+void Player::update(float dt, InputState input) {
   // Invulnerability Timer
   if (m_isInvulnerable) {
     m_invulnerableTimer += dt;
@@ -198,15 +199,11 @@ void Player::update(float dt) {
   b2Vec2 pos = b2Body_GetPosition(m_bodyId);
   b2Vec2 vel = b2Body_GetLinearVelocity(m_bodyId);
 
-  // Actualizar gráfico SFML
-  m_sprite.setPosition({pos.x * Physics::SCALE, pos.y * Physics::SCALE});
+  // Actualizar gráfico SFML (solo si algo cambió)
+  SpriteSync::position(m_sprite, {pos.x * Physics::SCALE, pos.y * Physics::SCALE});
 
   // Scale flipping based on direction
-  if (m_facingRight) {
-    m_sprite.setScale({2.5f, 2.5f});
-  } else {
-    m_sprite.setScale({-2.5f, 2.5f});
-  }
+  SpriteSync::scale(m_sprite, {m_facingRight ? 2.5f : -2.5f, 2.5f});
 
   // Chequeo de suelo mejorado (Hysteresis/Timer)
   // El problema: En el pico del salto, vel.y es ~0, lo que activaba m_canJump y
@@ -227,7 +224,7 @@ void Player::update(float dt) {
 
   // Variable gravity for snappier jumps (Mario-style)
   // Apply extra downward force when falling or when jump button released
-  bool jumpHeld = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up);
+  bool jumpHeld = input.held(InputState::Jump);
 
   // Fireball cooldown
   if (m_fireballCooldown > 0.0f) {
@@ -540,12 +537,30 @@ void Player::updateAnimation(float dt) {
   }
 }
 
-void Player::draw(sf::RenderWindow &window) { window.draw(m_sprite); }
+void Player::draw(sf::RenderTarget &target) {
+  currentSheet().draw(target, m_sprite, m_paletteVariant);
+}
+
+void Player::snapshot(RenderSnapshot &snapshot) const {
+  snapshot.addSprite(m_sprite, &currentSheet(), m_paletteVariant);
+}
+
+const PaletteSheet &Player::currentSheet() const {
+  const sf::Texture *texture = &m_sprite.getTexture();
+  if (texture == &m_fireTexture) {
+    return m_fireSheet;
+  }
+  return texture == &m_bigTexture ? m_bigSheet : m_smallSheet;
+}
 
 sf::Vector2f Player::getPosition() const { return m_sprite.getPosition(); }
 
 sf::FloatRect Player::getBounds() const { return m_sprite.getGlobalBounds(); }
 
+float Player::getHalfHeight() const {
+  return (m_bodyShape == BodyShape::Big ? BIG_BODY_HEIGHT : m_height) / 2.0f;
+}
+
 b2Vec2 Player::getVelocity() const {
   if (b2Body_IsValid(m_bodyId)) {
     return b2Body_GetLinearVelocity(m_bodyId);
@@ -561,31 +576,12 @@ void Player::grow() {
   m_sprite.setTexture(m_bigTexture);
 
   // Resize Physics Body
-  // Destroy old
-  b2Vec2 pos = b2Body_GetPosition(m_bodyId);
-  b2Vec2 vel = b2Body_GetLinearVelocity(m_bodyId);
-  b2DestroyBody(m_bodyId);
-
-  // Create new (Taller)
-  b2BodyDef bodyDef = b2DefaultBodyDef();
-  bodyDef.type = b2_dynamicBody;
   // Adjust Y position upward to account for taller hitbox
   // Big Mario hitbox: 28x52 pixels (scaled from sprite ~14x26 base * 2)
-  bodyDef.position = (b2Vec2){pos.x, pos.y - (26.0f / Physics::SCALE)};
-  bodyDef.fixedRotation = true;
-
-  m_bodyId = b2CreateBody(m_physics.worldId(), &bodyDef);
-
-  // Make Box for Big Mario: 28x52 pixels to better match sprite collision
-  b2Polygon box = b2MakeBox((28.0f / 2.0f) / Physics::SCALE,
-                            (52.0f / 2.0f) / Physics::SCALE);
-  b2ShapeDef shapeDef = b2DefaultShapeDef();
-  shapeDef.density = 1.0f;
-  // shapeDef.friction = 0.3f;
-
-  b2CreatePolygonShape(m_bodyId, &shapeDef, &box);
-
-  b2Body_SetLinearVelocity(m_bodyId, vel); // Maintain momentum
+  b2Vec2 pos = b2Body_GetPosition(m_bodyId);
+  b2Vec2 vel = b2Body_GetLinearVelocity(m_bodyId);
+  createBody(BodyShape::Big, (b2Vec2){pos.x, pos.y - (26.0f / Physics::SCALE)},
+             vel); // Maintain momentum
 }
 
 void Player::becomeFireMario() {
@@ -614,7 +610,10 @@ void Player::takeDamage() {
   if (m_isInvulnerable || m_isDead)
     return;
 
-  m_deathSound.play(); // Play death/damage sound
+  // Losing a power level; die() emits its own event
+  if (m_isBig)
+    pushEvent(m_events, GameEventType::Damage, getPosition().x,
+              getPosition().y);
 
   if (m_isFireMario) {
     // Fire Mario -> Big Mario
@@ -634,31 +633,8 @@ void Player::takeDamage() {
     m_sprite.setTexture(m_texture);
 
     // Revert Physics Body to Small
-    b2Vec2 pos = b2Body_GetPosition(m_bodyId);
-    b2Vec2 vel = b2Body_GetLinearVelocity(m_bodyId);
-
-    b2DestroyBody(m_bodyId);
-
-    // Create Small Body
-    b2BodyDef bodyDef = b2DefaultBodyDef();
-    bodyDef.type = b2_dynamicBody;
-    bodyDef.position = pos;
-    bodyDef.fixedRotation = true;
-
-    m_bodyId = b2CreateBody(m_physics.worldId(), &bodyDef);
-
-    // Original Small Box
-    b2Polygon dynamicBox = b2MakeBox((m_width / 2.0f) / Physics::SCALE,
-                                     (m_height / 2.0f) / Physics::SCALE);
-    b2ShapeDef shapeDef = b2DefaultShapeDef();
-    shapeDef.density = 1.0f;
-    // shapeDef.friction = 0.3f;
-
-    b2CreatePolygonShape(m_bodyId, &shapeDef, &dynamicBox);
-
-    b2Body_SetLinearVelocity(m_bodyId, vel);
-
-    // Sound effect here if we had audio
+    createBody(BodyShape::Small, b2Body_GetPosition(m_bodyId),
+               b2Body_GetLinearVelocity(m_bodyId));
   } else {
     die();
   }
@@ -670,7 +646,7 @@ void Player::die() {
 
   m_isDead = true;
   m_state = State::Dead;
-  m_deathSound.play(); // Play death sound
+  pushEvent(m_events, GameEventType::Die, getPosition().x, getPosition().y);
 
   // Always use small Mario sprite for death animation
   m_isBig = false;
@@ -678,48 +654,13 @@ void Player::die() {
   m_sprite.setTexture(m_texture); // Switch to small Mario texture
   m_sprite.setScale({2.5f, 2.5f}); // Reset scale for small Mario
 
-  // Jump up
-  b2Vec2 vel = b2Body_GetLinearVelocity(m_bodyId);
-  b2Body_SetLinearVelocity(m_bodyId, (b2Vec2){0.0f, -20.0f}); // Jump (Higher)
-
-  // Disable collisions by destroying shapes but keeping body for logic?
-  // Or just set shape filter.
-  // Box2D v3: we can just destroy shapes.
-  // But b2Body needs shape to have mass?
-  // If we destroy shape, mass becomes 0? b2Body w/o shape is just a point.
-  // If it's dynamic, it might not move without mass if forces dependent on mass
-  // are applied? Actually gravity is applied as force = m * g. We should better
-  // use filter to collide with nothing.
-
-  // Changing filter requires accessing the shape ID.
-  // Since I don't store shape ID, I will just destroy body and create a new one
-  // that collides with nothing.
-
-  b2Vec2 pos = b2Body_GetPosition(m_bodyId);
-  b2DestroyBody(m_bodyId);
-
-  b2BodyDef bodyDef = b2DefaultBodyDef();
-  bodyDef.type = b2_dynamicBody;
-  bodyDef.position = pos;
-  bodyDef.fixedRotation = true;
-  // Set linear velocity
-  b2BodyId newBody = b2CreateBody(m_physics.worldId(), &bodyDef);
-  b2Body_SetLinearVelocity(newBody, (b2Vec2){0.0f, -20.0f}); // Jump (Higher)
-
-  // Add shape with interaction filter that hits nothing
-  b2Polygon box = b2MakeBox((m_width / 2.0f) / Physics::SCALE,
-                            (m_height / 2.0f) / Physics::SCALE);
-  b2ShapeDef shapeDef = b2DefaultShapeDef();
-  shapeDef.density = 1.0f;
-  shapeDef.filter.categoryBits = 0; // Collide with nothing
-  shapeDef.filter.maskBits = 0;
-
-  b2CreatePolygonShape(newBody, &shapeDef, &box);
-
-  m_bodyId = newBody;
+  // Jump up, with a body that collides with nothing so Mario falls
+  // through the level
+  createBody(BodyShape::Dead, b2Body_GetPosition(m_bodyId),
+             (b2Vec2){0.0f, -20.0f}); // Jump (Higher)
 }
 
-bool Player::tryShootFireball() {
+bool Player::tryShootFireball(InputState input) {
   // Only Fire Mario can shoot (and not if dead or frozen)
   if (!m_isFireMario || m_isDead || m_frozen)
     return false;
@@ -728,8 +669,8 @@ bool Player::tryShootFireball() {
   if (m_fireballCooldown > 0.0f)
     return false;
 
-  // Check if Space is pressed
-  if (!sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space))
+  // Check if fire (Space) is pressed
+  if (!input.held(InputState::Fire))
     return false;
 
   // Fire!
@@ -746,4 +687,72 @@ void Player::freeze() {
   if (b2Body_IsValid(m_bodyId)) {
     b2Body_SetLinearVelocity(m_bodyId, (b2Vec2){0.0f, 0.0f});
   }
-}
\ No newline at end of file
+}
+
+void Player::saveState(StateWriter &writer) const {
+  writer.write<std::uint8_t>(m_canJump);
+  writer.write<std::uint8_t>(m_isBig);
+  writer.write<std::uint8_t>(m_isFireMario);
+  writer.write<std::uint8_t>(m_isDead);
+  writer.write<std::uint8_t>(m_isInvulnerable);
+  writer.write<std::uint8_t>(m_frozen);
+  writer.write<std::uint8_t>(m_facingRight);
+  writer.write<std::uint8_t>(m_isThrowing);
+  writer.write(m_state);
+  writer.write(m_bodyShape);
+  writer.write(m_invulnerableTimer);
+  writer.write(m_animationTimer);
+  writer.write(m_groundTimer);
+  writer.write(m_runTimer);
+  writer.write<std::int32_t>(m_currentFrame);
+  writer.write(m_fireballCooldown);
+  writer.write(m_throwTimer);
+  writer.writeSprite(m_sprite);
+  writer.writeBody(m_bodyId);
+}
+
+bool Player::loadState(StateReader &reader) {
+  std::uint8_t flags[8] = {};
+  for (std::uint8_t &flag : flags) {
+    reader.read(flag);
+  }
+  State state = m_state;
+  BodyShape bodyShape = m_bodyShape;
+  std::int32_t currentFrame = 0;
+  reader.read(state);
+  reader.read(bodyShape);
+  reader.read(m_invulnerableTimer);
+  reader.read(m_animationTimer);
+  reader.read(m_groundTimer);
+  reader.read(m_runTimer);
+  reader.read(currentFrame);
+  reader.read(m_fireballCooldown);
+  reader.read(m_throwTimer);
+  reader.readSprite(m_sprite);
+  BodyState body;
+  reader.readBody(body);
+  if (!reader.ok()) {
+    return false;
+  }
+
+  m_canJump = flags[0];
+  m_isBig = flags[1];
+  m_isFireMario = flags[2];
+  m_isDead = flags[3];
+  m_isInvulnerable = flags[4];
+  m_frozen = flags[5];
+  m_facingRight = flags[6];
+  m_isThrowing = flags[7];
+  m_state = state;
+  m_currentFrame = currentFrame;
+
+  // The texture follows the power level (dead Mario uses the small sheet)
+  m_sprite.setTexture(m_isFireMario ? m_fireTexture
+                                    : (m_isBig ? m_bigTexture : m_texture));
+
+  if (bodyShape != m_bodyShape || !b2Body_IsValid(m_bodyId)) {
+    createBody(bodyShape, body.position, body.linearVelocity);
+  }
+  body.apply(m_bodyId);
+  return true;
+}
@@ -0,0 +1,143 @@
+#include "RenderSnapshot.hpp"
+#include "PaletteSheet.hpp"
+#include "StaticLayerCache.hpp"
+#include <algorithm>
+#include <cmath>
+
+void RenderSnapshot::clear() {
+    vertices.clear();
+    batches.clear();
+    layers.clear();
+}
+
+bool RenderSnapshot::isVisible(const sf::FloatRect& bounds) const {
+    sf::FloatRect view(camera.getCenter() - camera.getSize() / 2.0f,
+                       camera.getSize());
+    return view.findIntersection(bounds).has_value();
+}
+
+void RenderSnapshot::extendBatch(const sf::Texture* texture, std::size_t count,
+                                 const PaletteSheet* palette, int variant) {
+    if (!batches.empty() && batches.back().layer < 0 &&
+        batches.back().texture == texture && batches.back().palette == palette &&
+        batches.back().variant == variant) {
+        batches.back().count += count;
+    } else {
+        batches.push_back({texture, vertices.size() - count, count, -1, palette, variant});
+    }
+}
+
+void RenderSnapshot::addQuad(const sf::Vertex (&corners)[4],
+                             const sf::Texture* texture,
+                             const PaletteSheet* palette, int variant) {
+    vertices.push_back(corners[0]);
+    vertices.push_back(corners[1]);
+    vertices.push_back(corners[2]);
+    vertices.push_back(corners[2]);
+    vertices.push_back(corners[1]);
+    vertices.push_back(corners[3]);
+    extendBatch(texture, 6, palette, variant);
+}
+
+void RenderSnapshot::addSprite(const sf::Sprite& sprite, const PaletteSheet* palette,
+                               int variant) {
+    if (!isVisible(sprite.getGlobalBounds())) {
+        return;
+    }
+    // Same corners as sf::Sprite (a negative rect size flips the image)
+    sf::FloatRect rect(sprite.getTextureRect());
+    sf::Vector2f size(std::abs(rect.size.x), std::abs(rect.size.y));
+    const sf::Transform& transform = sprite.getTransform();
+    sf::Color color = sprite.getColor();
+
+    sf::Vertex corners[4];
+    corners[0] = {transform.transformPoint({0.0f, 0.0f}), color, rect.position};
+    corners[1] = {transform.transformPoint({0.0f, size.y}), color,
+                  {rect.position.x, rect.position.y + rect.size.y}};
+    corners[2] = {transform.transformPoint({size.x, 0.0f}), color,
+                  {rect.position.x + rect.size.x, rect.position.y}};
+    corners[3] = {transform.transformPoint(size), color,
+                  rect.position + rect.size};
+    addQuad(corners, &sprite.getTexture(), palette, variant);
+}
+
+void RenderSnapshot::addRectangle(const sf::RectangleShape& shape) {
+    if (!isVisible(shape.getGlobalBounds())) {
+        return;
+    }
+    sf::Vector2f size = shape.getSize();
+    const sf::Transform& transform = shape.getTransform();
+    sf::Color color = shape.getFillColor();
+
+    sf::Vertex corners[4];
+    corners[0] = {transform.transformPoint({0.0f, 0.0f}), color};
+    corners[1] = {transform.transformPoint({0.0f, size.y}), color};
+    corners[2] = {transform.transformPoint({size.x, 0.0f}), color};
+    corners[3] = {transform.transformPoint(size), color};
+    addQuad(corners, nullptr);
+}
+
+void RenderSnapshot::addTiles(const sf::VertexArray& triangles,
+                              const sf::Texture* texture) {
+    // Every tile is 6 vertices (two triangles); keep the ones that overlap
+    // the camera horizontally
+    float left = camera.getCenter().x - camera.getSize().x / 2.0f;
+    float right = camera.getCenter().x + camera.getSize().x / 2.0f;
+    std::size_t start = vertices.size();
+    for (std::size_t i = 0; i + 6 <= triangles.getVertexCount(); i += 6) {
+        float minX = triangles[i].position.x;
+        float maxX = minX;
+        for (std::size_t v = 1; v < 6; ++v) {
+            minX = std::min(minX, triangles[i + v].position.x);
+            maxX = std::max(maxX, triangles[i + v].position.x);
+        }
+        if (maxX < left || minX > right) {
+            continue;
+        }
+        for (std::size_t v = 0; v < 6; ++v) {
+            vertices.push_back(triangles[i + v]);
+        }
+    }
+    if (vertices.size() > start) {
+        extendBatch(texture, vertices.size() - start);
+    }
+}
+
+void RenderSnapshot::addLayer(std::shared_ptr<const RenderSnapshot> layer) {
+    if (!layer) {
+        return;
+    }
+    layers.push_back(std::move(layer));
+    batches.push_back({nullptr, 0, 0, static_cast<int>(layers.size()) - 1});
+}
+
+void RenderSnapshot::draw(sf::RenderTarget& target, StaticLayerCache* cache) const {
+    // Whole-pixel camera: with a target as big as the view, sprites land
+    // on the pixel grid instead of shimmering as the camera scrolls
+    sf::View view = camera;
+    sf::Vector2f center = view.getCenter();
+    view.setCenter({std::round(center.x), std::round(center.y)});
+    target.setView(view);
+    drawBatches(target, cache);
+}
+
+void RenderSnapshot::drawBatches(sf::RenderTarget& target,
+                                 StaticLayerCache* cache) const {
+    for (const Batch& batch : batches) {
+        if (batch.layer >= 0) {
+            const std::shared_ptr<const RenderSnapshot>& layer = layers[batch.layer];
+            if (cache) {
+                cache->draw(target, layer, camera);
+            } else {
+                layer->drawBatches(target);
+            }
+            continue;
+        }
+        sf::RenderStates states(batch.texture);
+        if (batch.palette) {
+            batch.palette->apply(states, batch.variant);
+        }
+        target.draw(vertices.data() + batch.first, batch.count,
+                    sf::PrimitiveType::Triangles, states);
+    }
+}
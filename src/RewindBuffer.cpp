@@ -0,0 +1,186 @@
+#include "RewindBuffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+void writeVarint(std::vector<std::uint8_t>& out, size_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+size_t readVarint(const std::uint8_t*& data, const std::uint8_t* end) {
+    size_t value = 0;
+    for (int shift = 0; data < end; shift += 7) {
+        std::uint8_t byte = *data++;
+        value |= static_cast<size_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+    return value;
+}
+
+} // namespace
+
+RewindBuffer::RewindBuffer(size_t byteBudget, size_t maxFrames,
+                           int keyframeInterval)
+    : m_arena(byteBudget), m_frames(std::max<size_t>(maxFrames, 2)),
+      m_keyframeInterval(std::max(keyframeInterval, 1)) {}
+
+void RewindBuffer::clear() {
+    m_first = 0;
+    m_count = 0;
+    m_writeOffset = 0;
+    m_forceKeyframe = true;
+}
+
+size_t RewindBuffer::bytesUsed() const {
+    size_t bytes = 0;
+    for (size_t i = 0; i < m_count; ++i) {
+        bytes += m_frames[(m_first + i) % m_frames.size()].size;
+    }
+    return bytes;
+}
+
+RewindBuffer::Frame& RewindBuffer::frameAt(size_t index) {
+    return m_frames[(m_first + index) % m_frames.size()];
+}
+
+void RewindBuffer::dropOldestGroup() {
+    // The oldest frame is always a keyframe; its deltas go with it
+    do {
+        m_first = (m_first + 1) % m_frames.size();
+        --m_count;
+    } while (m_count > 0 && !frameAt(0).keyframe);
+}
+
+bool RewindBuffer::overlapsOldest(size_t offset, size_t size) const {
+    if (m_count == 0) {
+        return false;
+    }
+    const Frame& oldest = m_frames[m_first];
+    return offset < oldest.offset + oldest.size && oldest.offset < offset + size;
+}
+
+void RewindBuffer::encode(const std::vector<std::uint8_t>& state,
+                          const std::uint8_t* reference,
+                          std::vector<std::uint8_t>& out) {
+    // Tokens: <zero run length> <literal length> <literal bytes>
+    out.clear();
+    const size_t size = state.size();
+    size_t i = 0;
+    while (i < size) {
+        size_t zeroStart = i;
+        while (i < size && (state[i] ^ (reference ? reference[i] : 0)) == 0) {
+            ++i;
+        }
+        size_t literalStart = i;
+        // A literal run ends at the first pair of zero bytes, so isolated
+        // zeros inside changed floats do not split it
+        while (i < size) {
+            bool zero = (state[i] ^ (reference ? reference[i] : 0)) == 0;
+            bool nextZero = i + 1 >= size ||
+                            (state[i + 1] ^ (reference ? reference[i + 1] : 0)) == 0;
+            if (zero && nextZero) {
+                break;
+            }
+            ++i;
+        }
+        writeVarint(out, literalStart - zeroStart);
+        writeVarint(out, i - literalStart);
+        for (size_t j = literalStart; j < i; ++j) {
+            out.push_back(state[j] ^ (reference ? reference[j] : 0));
+        }
+    }
+}
+
+void RewindBuffer::decode(const std::uint8_t* data, size_t size,
+                          std::vector<std::uint8_t>& state) {
+    // XORs the delta onto 'state' in place
+    const std::uint8_t* end = data + size;
+    size_t offset = 0;
+    while (data < end) {
+        offset += readVarint(data, end);
+        size_t literals = readVarint(data, end);
+        literals = std::min({literals, static_cast<size_t>(end - data),
+                             state.size() - std::min(offset, state.size())});
+        for (size_t j = 0; j < literals; ++j) {
+            state[offset + j] ^= data[j];
+        }
+        data += literals;
+        offset += literals;
+    }
+}
+
+void RewindBuffer::push(const std::vector<std::uint8_t>& state) {
+    bool keyframe = m_forceKeyframe || m_sinceKeyframe >= m_keyframeInterval ||
+                    state.size() != m_keyframe.size();
+    encode(state, keyframe ? nullptr : m_keyframe.data(), m_scratch);
+    if (m_scratch.size() > m_arena.size()) {
+        clear(); // A single state larger than the whole budget
+        return;
+    }
+
+    if (keyframe) {
+        m_keyframe = state;
+        m_sinceKeyframe = 0;
+        m_forceKeyframe = false;
+    }
+    ++m_sinceKeyframe;
+
+    // Linear write position; wrap to the start when the tail is too short
+    size_t offset = m_writeOffset;
+    if (offset + m_scratch.size() > m_arena.size()) {
+        // Frames past the write position are from the previous lap (the
+        // oldest ones); the skipped tail takes them with it
+        while (m_count > 0 && frameAt(0).offset >= m_writeOffset) {
+            dropOldestGroup();
+        }
+        offset = 0;
+    }
+    while (overlapsOldest(offset, m_scratch.size()) || m_count == m_frames.size()) {
+        dropOldestGroup();
+    }
+    if (m_count == 0 && !keyframe) {
+        // Its keyframe was just evicted: the delta is useless on its own
+        m_forceKeyframe = true;
+        return;
+    }
+
+    std::memcpy(m_arena.data() + offset, m_scratch.data(), m_scratch.size());
+    m_writeOffset = offset + m_scratch.size();
+
+    m_frames[(m_first + m_count) % m_frames.size()] = {
+        offset, m_scratch.size(), state.size(), keyframe};
+    ++m_count;
+}
+
+void RewindBuffer::decodeFrame(size_t index, std::vector<std::uint8_t>& state) {
+    size_t key = index;
+    while (key > 0 && !frameAt(key).keyframe) {
+        --key;
+    }
+    const Frame& keyFrame = frameAt(key);
+    state.assign(keyFrame.rawSize, 0);
+    decode(m_arena.data() + keyFrame.offset, keyFrame.size, state);
+    if (key != index) {
+        const Frame& frame = frameAt(index);
+        decode(m_arena.data() + frame.offset, frame.size, state);
+    }
+}
+
+bool RewindBuffer::stepBack(std::vector<std::uint8_t>& state) {
+    if (m_count < 2) {
+        return false;
+    }
+    --m_count;
+    m_writeOffset = frameAt(m_count).offset;
+    decodeFrame(m_count - 1, state);
+    // Later pushes start a new group from the restored state
+    m_forceKeyframe = true;
+    return true;
+}
@@ -0,0 +1,47 @@
+#include "SoundBufferCache.hpp"
+#include "PcmAssets.hpp"
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+// Raw PCM written by make assets, if it exists and is newer than 'path'
+bool loadCached(const std::string& path, sf::SoundBuffer& buffer) {
+    const PcmAsset* asset = PcmAsset::findSource(path);
+    if (!asset) {
+        return false;
+    }
+    std::error_code error;
+    auto cached = std::filesystem::last_write_time(asset->path(), error);
+    if (error) {
+        return false; // Not generated: decode the source
+    }
+    auto source = std::filesystem::last_write_time(path, error);
+    if (!error && source > cached) {
+        return false; // Stale
+    }
+    return PcmAsset::load(asset->path(), buffer);
+}
+} // namespace
+
+const sf::SoundBuffer& SoundBufferCache::get(const std::string& path) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::unique_ptr<sf::SoundBuffer>> buffers;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = buffers.find(path);
+    if (it != buffers.end()) {
+        return *it->second;
+    }
+
+    auto buffer = std::make_unique<sf::SoundBuffer>();
+    if (loadCached(path, *buffer)) {
+        return *buffers.emplace(path, std::move(buffer)).first->second;
+    }
+    if (!buffer->loadFromFile(path)) {
+        std::cerr << "Error loading " << path << std::endl;
+    }
+    return *buffers.emplace(path, std::move(buffer)).first->second;
+}
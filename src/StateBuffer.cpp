@@ -0,0 +1,136 @@
+#include "StateBuffer.hpp"
+
+BodyState BodyState::capture(b2BodyId bodyId) {
+    BodyState state;
+    if (!b2Body_IsValid(bodyId)) {
+        return state;
+    }
+    state.valid = true;
+    state.type = static_cast<std::uint8_t>(b2Body_GetType(bodyId));
+    b2Transform transform = b2Body_GetTransform(bodyId);
+    state.position = transform.p;
+    state.rotation = transform.q;
+    state.linearVelocity = b2Body_GetLinearVelocity(bodyId);
+    state.angularVelocity = b2Body_GetAngularVelocity(bodyId);
+    state.awake = b2Body_IsAwake(bodyId);
+    state.enabled = b2Body_IsEnabled(bodyId);
+    return state;
+}
+
+void BodyState::apply(b2BodyId bodyId) const {
+    if (!valid || !b2Body_IsValid(bodyId)) {
+        return;
+    }
+    b2BodyType bodyType = static_cast<b2BodyType>(type);
+    if (b2Body_GetType(bodyId) != bodyType) {
+        b2Body_SetType(bodyId, bodyType);
+    }
+    if (b2Body_IsEnabled(bodyId) != enabled) {
+        if (enabled) {
+            b2Body_Enable(bodyId);
+        } else {
+            b2Body_Disable(bodyId);
+        }
+    }
+    b2Body_SetTransform(bodyId, position, rotation);
+    b2Body_SetLinearVelocity(bodyId, linearVelocity);
+    b2Body_SetAngularVelocity(bodyId, angularVelocity);
+    b2Body_SetAwake(bodyId, awake);
+}
+
+void StateWriter::writeBytes(const void* data, size_t size) {
+    size_t offset = m_out.size();
+    m_out.resize(offset + size);
+    std::memcpy(m_out.data() + offset, data, size);
+}
+
+void StateWriter::writeBody(b2BodyId bodyId) {
+    BodyState state = BodyState::capture(bodyId);
+    write<std::uint8_t>(state.valid ? 1 : 0);
+    if (!state.valid) {
+        return;
+    }
+    write(state.type);
+    write(state.position.x);
+    write(state.position.y);
+    write(state.rotation.c);
+    write(state.rotation.s);
+    write(state.linearVelocity.x);
+    write(state.linearVelocity.y);
+    write(state.angularVelocity);
+    write<std::uint8_t>((state.awake ? 1 : 0) | (state.enabled ? 2 : 0));
+}
+
+void StateWriter::writeSprite(const sf::Sprite& sprite) {
+    const sf::IntRect& rect = sprite.getTextureRect();
+    write<std::int32_t>(rect.position.x);
+    write<std::int32_t>(rect.position.y);
+    write<std::int32_t>(rect.size.x);
+    write<std::int32_t>(rect.size.y);
+    write(sprite.getOrigin().x);
+    write(sprite.getOrigin().y);
+    write(sprite.getPosition().x);
+    write(sprite.getPosition().y);
+    write(sprite.getScale().x);
+    write(sprite.getScale().y);
+    write(sprite.getColor().toInteger());
+}
+
+bool StateReader::readBytes(void* data, size_t size) {
+    if (!m_ok || m_size - m_offset < size) {
+        m_ok = false;
+        return false;
+    }
+    std::memcpy(data, m_data + m_offset, size);
+    m_offset += size;
+    return true;
+}
+
+bool StateReader::readBody(BodyState& body) {
+    std::uint8_t valid = 0;
+    read(valid);
+    body = BodyState();
+    if (!valid) {
+        return m_ok;
+    }
+    std::uint8_t flags = 0;
+    body.valid = true;
+    read(body.type);
+    read(body.position.x);
+    read(body.position.y);
+    read(body.rotation.c);
+    read(body.rotation.s);
+    read(body.linearVelocity.x);
+    read(body.linearVelocity.y);
+    read(body.angularVelocity);
+    read(flags);
+    body.awake = (flags & 1) != 0;
+    body.enabled = (flags & 2) != 0;
+    return m_ok;
+}
+
+bool StateReader::readSprite(sf::Sprite& sprite) {
+    std::int32_t rx = 0, ry = 0, rw = 0, rh = 0;
+    float ox = 0, oy = 0, px = 0, py = 0, sx = 0, sy = 0;
+    std::uint32_t color = 0;
+    read(rx);
+    read(ry);
+    read(rw);
+    read(rh);
+    read(ox);
+    read(oy);
+    read(px);
+    read(py);
+    read(sx);
+    read(sy);
+    read(color);
+    if (!m_ok) {
+        return false;
+    }
+    sprite.setTextureRect(sf::IntRect({rx, ry}, {rw, rh}));
+    sprite.setOrigin({ox, oy});
+    sprite.setPosition({px, py});
+    sprite.setScale({sx, sy});
+    sprite.setColor(sf::Color(color));
+    return true;
+}
@@ -0,0 +1,49 @@
+#include "StateHash.hpp"
+
+namespace {
+const std::uint64_t FNV_OFFSET = 14695981039346656037ULL;
+const std::uint64_t FNV_PRIME = 1099511628211ULL;
+} // namespace
+
+std::uint64_t StateHash::fnv1a(const std::uint8_t* data, size_t size) {
+    std::uint64_t hash = FNV_OFFSET;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+std::uint64_t StateHash::combined() const {
+    // Hash of the part hashes, so the order of subsystems matters
+    std::uint64_t hash = FNV_OFFSET;
+    for (std::uint64_t part : parts) {
+        for (int byte = 0; byte < 8; ++byte) {
+            hash ^= (part >> (byte * 8)) & 0xFF;
+            hash *= FNV_PRIME;
+        }
+    }
+    return hash;
+}
+
+int StateHash::firstMismatch(const StateHash& other) const {
+    for (int i = 0; i < Count; ++i) {
+        if (parts[i] != other.parts[i]) {
+            return i;
+        }
+    }
+    return Count;
+}
+
+const char* StateHash::subsystemName(int subsystem) {
+    switch (subsystem) {
+    case Player: return "player";
+    case Blocks: return "blocks";
+    case Items: return "items";
+    case Enemies: return "enemies";
+    case Fireballs: return "fireballs";
+    case Spawns: return "spawns";
+    case Goal: return "goal";
+    }
+    return "?";
+}
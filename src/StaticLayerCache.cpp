@@ -0,0 +1,83 @@
+#include "StaticLayerCache.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+
+const sf::BlendMode StaticLayerCache::PREMULTIPLIED(
+    sf::BlendMode::Factor::One, sf::BlendMode::Factor::OneMinusSrcAlpha);
+
+StaticLayerCache::StaticLayerCache(sf::Vector2u tileSize, std::size_t maxTiles)
+: m_tileSize(tileSize), m_maxTiles(std::max<std::size_t>(maxTiles, 4))
+{
+}
+
+const sf::Texture* StaticLayerCache::tileTexture(
+    const std::shared_ptr<const RenderSnapshot>& layer, int x, int y)
+{
+    for (auto it = m_tiles.begin(); it != m_tiles.end(); ++it) {
+        if (it->x == x && it->y == y && it->layer.lock() == layer) {
+            m_tiles.splice(m_tiles.begin(), m_tiles, it);
+            return &it->texture->getTexture();
+        }
+    }
+
+    // Miss: once the cache is full, recycle a stale tile (its layer is
+    // gone, so it can never hit again) or else the least recently used
+    // one, so render textures are not reallocated
+    std::unique_ptr<sf::RenderTexture> texture;
+    if (m_tiles.size() >= m_maxTiles) {
+        auto victim = std::find_if(m_tiles.rbegin(), m_tiles.rend(),
+                                   [](const Tile& tile) { return tile.layer.expired(); });
+        auto it = victim == m_tiles.rend() ? std::prev(m_tiles.end())
+                                           : std::prev(victim.base());
+        texture = std::move(it->texture);
+        m_tiles.erase(it);
+    } else {
+        texture = std::make_unique<sf::RenderTexture>();
+        if (!texture->resize(m_tileSize)) {
+            std::cerr << "Error creating a static layer tile" << std::endl;
+            return nullptr;
+        }
+    }
+
+    sf::Vector2f size(static_cast<float>(m_tileSize.x),
+                      static_cast<float>(m_tileSize.y));
+    texture->setView(sf::View(sf::FloatRect({x * size.x, y * size.y}, size)));
+    texture->clear(sf::Color::Transparent);
+    layer->drawBatches(*texture);
+    texture->display();
+    ++m_rendered;
+
+    m_tiles.push_front({layer, x, y, std::move(texture)});
+    return &m_tiles.front().texture->getTexture();
+}
+
+void StaticLayerCache::draw(sf::RenderTarget& target,
+                            const std::shared_ptr<const RenderSnapshot>& layer,
+                            const sf::View& camera)
+{
+    sf::RenderStates states;
+    states.blendMode = PREMULTIPLIED;
+    float tileW = static_cast<float>(m_tileSize.x);
+    float tileH = static_cast<float>(m_tileSize.y);
+    sf::Vector2f topLeft = camera.getCenter() - camera.getSize() / 2.0f;
+    sf::Vector2f bottomRight = topLeft + camera.getSize();
+
+    int x0 = static_cast<int>(std::floor(topLeft.x / tileW));
+    int y0 = static_cast<int>(std::floor(topLeft.y / tileH));
+    int x1 = static_cast<int>(std::ceil(bottomRight.x / tileW));
+    int y1 = static_cast<int>(std::ceil(bottomRight.y / tileH));
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            const sf::Texture* texture = tileTexture(layer, x, y);
+            if (!texture) {
+                layer->drawBatches(target); // No tiles: draw it directly
+                return;
+            }
+            sf::Sprite tile(*texture);
+            tile.setPosition({x * tileW, y * tileH});
+            target.draw(tile, states);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#include "TextureCache.hpp"
+#include "BakedAssets.hpp"
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace {
+std::atomic<bool> s_headless{false};
+} // namespace
+
+void TextureCache::setHeadless(bool headless) { s_headless = headless; }
+
+bool TextureCache::isHeadless() { return s_headless; }
+
+const sf::Texture& TextureCache::get(const std::string& path) {
+    if (s_headless) {
+        static const sf::Texture empty;
+        return empty;
+    }
+
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::unique_ptr<sf::Texture>> textures;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = textures.find(path);
+    if (it != textures.end()) {
+        return *it->second;
+    }
+
+    auto texture = std::make_unique<sf::Texture>();
+    if (!texture->loadFromFile(path)) {
+        std::cerr << "Error loading " << path << std::endl;
+    }
+    return *textures.emplace(path, std::move(texture)).first->second;
+}
+
+const sf::Texture& TextureCache::getTiled(const std::string& path,
+                                          const sf::IntRect& area) {
+    if (s_headless) {
+        static const sf::Texture empty;
+        return empty;
+    }
+
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::unique_ptr<sf::Texture>> textures;
+
+    std::string key = path + "#" + std::to_string(area.position.x) + "," +
+                      std::to_string(area.position.y) + "," +
+                      std::to_string(area.size.x) + "," +
+                      std::to_string(area.size.y);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = textures.find(key);
+    if (it != textures.end()) {
+        return *it->second;
+    }
+
+    auto texture = std::make_unique<sf::Texture>();
+    if (!texture->loadFromFile(path, false, area)) {
+        std::cerr << "Error loading " << path << std::endl;
+    }
+    texture->setRepeated(true);
+    return *textures.emplace(key, std::move(texture)).first->second;
+}
+
+const sf::Texture& TextureCache::getBaked(const std::string& name) {
+    if (s_headless) {
+        static const sf::Texture empty;
+        return empty;
+    }
+
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::unique_ptr<sf::Texture>> textures;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = textures.find(name);
+    if (it != textures.end()) {
+        return *it->second;
+    }
+
+    auto texture = std::make_unique<sf::Texture>();
+    const BakedAsset* asset = BakedAsset::find(name);
+    if (!asset) {
+        std::cerr << "Error loading baked asset " << name << std::endl;
+    } else if (!texture->loadFromFile(asset->path())) {
+        // Not generated (make assets): same result, baked at startup
+        sf::Image source;
+        if (!source.loadFromFile(asset->source)) {
+            std::cerr << "Error loading " << asset->source << std::endl;
+        }
+        if (!texture->loadFromImage(asset->bake(source))) {
+            std::cerr << "Error loading baked asset " << name << std::endl;
+        }
+    }
+    return *textures.emplace(name, std::move(texture)).first->second;
+}
@@ -0,0 +1,55 @@
+#include "VoicePool.hpp"
+
+VoicePool::VoicePool(std::size_t voices) {
+    m_voices.reserve(voices);
+    for (std::size_t i = 0; i < voices; ++i) {
+        m_voices.push_back(Voice{sf::Sound(m_silence)});
+    }
+}
+
+bool VoicePool::play(const sf::SoundBuffer& buffer, int priority, float volume) {
+    // Free voice first; otherwise the least important, then oldest, one
+    Voice* chosen = nullptr;
+    for (Voice& voice : m_voices) {
+        if (voice.sound.getStatus() == sf::SoundSource::Status::Stopped) {
+            chosen = &voice;
+            break;
+        }
+        if (!chosen || voice.priority < chosen->priority ||
+            (voice.priority == chosen->priority && voice.started < chosen->started)) {
+            chosen = &voice;
+        }
+    }
+    if (!chosen) {
+        return false;
+    }
+    if (chosen->sound.getStatus() != sf::SoundSource::Status::Stopped) {
+        if (chosen->priority > priority) {
+            return false;
+        }
+        chosen->sound.stop();
+    }
+
+    chosen->sound.setBuffer(buffer);
+    chosen->sound.setVolume(volume);
+    chosen->priority = priority;
+    chosen->started = ++m_plays;
+    chosen->sound.play();
+    return true;
+}
+
+void VoicePool::stopAll() {
+    for (Voice& voice : m_voices) {
+        voice.sound.stop();
+    }
+}
+
+std::size_t VoicePool::playingCount() const {
+    std::size_t count = 0;
+    for (const Voice& voice : m_voices) {
+        if (voice.sound.getStatus() != sf::SoundSource::Status::Stopped) {
+            ++count;
+        }
+    }
+    return count;
+}
@@ -1,28 +1,61 @@
+#include "AudioSystem.hpp"
+#include "GameSession.hpp"
 #include "GameWindow.hpp"
-#include "Level.hpp"
-#include "Physics.hpp"
-#include "Player.hpp"
+#include "Hud.hpp"
+#include "InputTrack.hpp"
+#include "MusicManager.hpp"
+#include "RewindBuffer.hpp"
+#include "StaticLayerCache.hpp"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
-// Encapsulate Game Session to easily reset level
-struct GameSession {
-  Physics physics;
-  std::unique_ptr<Level> level;
-  std::unique_ptr<Player> player;
-
-  GameSession(float width, float height, int levelNumber = 1) {
-    level = std::make_unique<Level>(physics, width, height, levelNumber);
-    player = std::make_unique<Player>(physics, 100.0f, 400.0f);
-  }
-};
-
-int main() {
+int main(int argc, char **argv) {
   const unsigned int WIDTH = 800;
   const unsigned int HEIGHT = 600;
 
-  GameWindow window(WIDTH, HEIGHT, "Mario - Demo (SFML + Box2D)");
+  // Input capture: --record PREFIX writes one PREFIX-<n>.rec track per run,
+  // --replay FILE plays a recorded run back before handing over the keyboard
+  // --stress SPEC plays a generated stress level (see StressLevelSpec)
+  // instead of levels 1 and 2
+  // --fps N renders at N Hz (60, 120, 144...; 0 = uncapped), --vsync syncs
+  // presents to the display instead. F3 prints frame pacing statistics.
+  // --scale N opens the window N times the game's 800x600 (it can also be
+  // resized; the picture is scaled by whole factors and letterboxed)
+  std::string recordPrefix;
+  std::string replayPath;
+  bool stressMode = false;
+  StressLevelSpec stressSpec;
+  unsigned int frameRate = 60;
+  bool vsync = false;
+  unsigned int windowScale = 1;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--record" && hasValue) {
+      recordPrefix = argv[++i];
+    } else if (arg == "--replay" && hasValue) {
+      replayPath = argv[++i];
+    } else if (arg == "--stress" && hasValue) {
+      if (!StressLevelSpec::parse(argv[++i], stressSpec)) {
+        return 2;
+      }
+      stressMode = true;
+    } else if (arg == "--fps" && hasValue) {
+      frameRate = static_cast<unsigned int>(std::max(0, std::atoi(argv[++i])));
+    } else if (arg == "--scale" && hasValue) {
+      windowScale = static_cast<unsigned int>(std::max(1, std::atoi(argv[++i])));
+    } else if (arg == "--vsync") {
+      vsync = true;
+    }
+  }
+
+  GameWindow window(WIDTH, HEIGHT, "Mario - Demo (SFML + Box2D)", windowScale);
+  window.setFrameRate(frameRate);
+  window.setVsync(vsync);
 
   // Load Font (Fallback system font since project might miss one)
   sf::Font font;
@@ -30,30 +63,29 @@ int main() {
     std::cerr << "Failed to load font C:/Windows/Fonts/arial.ttf" << std::endl;
   }
 
-  // SFML 3: Text constructor requires font as first argument
-  sf::Text uiText(font);
-  uiText.setCharacterSize(40);
-  uiText.setFillColor(sf::Color::White);
-
-  sf::Text hudText(font);
-  hudText.setCharacterSize(30);
-  hudText.setFillColor(sf::Color::White);
-  hudText.setPosition({60.f, 20.f}); // Moved right to make room for helmet icon
-
   // Load Helmet Icon for Lives display
   sf::Texture helmetTexture;
   if (!helmetTexture.loadFromFile("assets/images/casco.png")) {
       std::cerr << "Failed to load assets/images/casco.png" << std::endl;
   }
-  sf::Sprite helmetSprite(helmetTexture);
-  helmetSprite.setPosition({15.f, 18.f}); // Aligned with text center
-  helmetSprite.setScale({0.5f, 0.5f}); // Much larger icon
+
+  // Lives counter and message screens, cached offscreen (render thread only)
+  Hud hud(font, helmetTexture, {WIDTH, HEIGHT});
+  // Pre-rendered screen-sized tiles of the level's static layers (render
+  // thread only; 12 tiles are about 23 MB of VRAM)
+  StaticLayerCache staticCache({WIDTH, HEIGHT}, 12);
 
   // Load Menu Texture
   sf::Texture menuTexture;
   if (!menuTexture.loadFromFile("assets/images/menu.jpg")) {
       std::cerr << "Failed to load assets/images/menu.jpg" << std::endl;
   }
+  // The menu is drawn scaled to the window: smooth filtering with mipmaps
+  // instead of sampling the full-size image
+  menuTexture.setSmooth(true);
+  if (!menuTexture.generateMipmap()) {
+      std::cerr << "Failed to generate mipmaps for assets/images/menu.jpg" << std::endl;
+  }
   sf::Sprite menuSprite(menuTexture);
   
   // Scale and center the menu image to fit the 800x600 window
@@ -95,20 +127,15 @@ int main() {
   finalSprite.setScale({(float)WIDTH / finalTexSize.x, (float)HEIGHT / finalTexSize.y});
 
 
-  // Load Menu Sound
-  sf::SoundBuffer menuSoundBuffer;
-  if (!menuSoundBuffer.loadFromFile("assets/music/menu_sound.wav")) {
-      std::cerr << "Failed to load assets/music/menu_sound.wav" << std::endl;
-  }
-  sf::Sound menuSound(menuSoundBuffer);
+  // Sound effects play on the audio thread; gameplay only queues events
+  AudioSystem audio;
+  GameEventQueue *events = &audio.events();
 
-  // Load Background Music
-  sf::Music bgMusic;
-  if (!bgMusic.openFromFile("assets/music/cumbia.MP3")) {
-      std::cerr << "Failed to load assets/music/cumbia.MP3" << std::endl;
-  }
-  bgMusic.setLooping(true);
-  bgMusic.setVolume(50.0f); // Adjust volume if needed
+  // Background music, one track per level; opened in the background
+  // ahead of time so starting it never waits on the disk
+  MusicManager music;
+  music.setVolume(50.0f); // Adjust volume if needed
+  music.prefetch(1);
 
 
   // Game State
@@ -120,91 +147,147 @@ int main() {
 
   // Session - usar LEVEL_WIDTH desde Level.hpp (3200px)
   std::unique_ptr<GameSession> session =
-      std::make_unique<GameSession>((float)WIDTH, (float)HEIGHT);
+      std::make_unique<GameSession>((float)WIDTH, (float)HEIGHT, 1, events);
 
   // Camera
   sf::View camera(sf::FloatRect({0.f, 0.f}, {(float)WIDTH, (float)HEIGHT}));
 
+  // Every session gets its own input track; the previous one is saved when
+  // a new session starts. Rewinding ends the track: restored savestates
+  // rebuild the Box2D bodies without their contact cache, so the ticks
+  // after a rewind would not replay the same from a fresh session.
+  InputTrack recordTrack;
+  int recordCount = 0;
+  bool recording = true; // False after a rewind, until the next session
+  auto flushRecording = [&]() {
+    if (!recordPrefix.empty() && !recordTrack.empty()) {
+      recordTrack.saveToFile(recordPrefix + "-" + std::to_string(recordCount++) + ".rec");
+    }
+  };
+  // Last 10 seconds of the session; hold Backspace to scrub back
+  RewindBuffer rewind;
+  std::vector<std::uint8_t> stateBlob;
+
+  auto startSession = [&](int levelNumber) {
+    flushRecording();
+    recording = true;
+    rewind.clear();
+    if (stressMode) {
+      recordTrack.reset(Level::STRESS_LEVEL);
+      recordTrack.setStressSpec(stressSpec.toString());
+      session = std::make_unique<GameSession>((float)WIDTH, (float)HEIGHT, stressSpec, events);
+      return;
+    }
+    recordTrack.reset(levelNumber);
+    session = std::make_unique<GameSession>((float)WIDTH, (float)HEIGHT, levelNumber, events);
+  };
+
+  InputTrack replayTrack;
+  std::unique_ptr<InputPlayback> replay;
+  if (!replayPath.empty() && replayTrack.loadFromFile(replayPath)) {
+    // A generated level is rebuilt from the spec stored in the track
+    if (replayTrack.level() == Level::STRESS_LEVEL) {
+      if (!replayTrack.stressSpec().empty()) {
+        if (!StressLevelSpec::parse(replayTrack.stressSpec(), stressSpec)) {
+          return 2;
+        }
+        stressMode = true;
+      } else if (!stressMode) {
+        std::cerr << "Error: " << replayPath
+                  << " is a stress level recorded without its spec; pass the"
+                     " same --stress SPEC" << std::endl;
+        return 2;
+      }
+    }
+    replay = std::make_unique<InputPlayback>(replayTrack);
+    currentLevel = replayTrack.level();
+    startSession(currentLevel);
+    music.play(currentLevel);
+    currentState = PLAYING;
+  }
+
+  // Gameplay input for one tick: the replay while it lasts, then the keyboard
+  auto nextInput = [&]() {
+    InputState input = (replay && !replay->finished()) ? replay->next()
+                                                       : GameWindow::sampleInput();
+    if (recording) {
+      recordTrack.push(input);
+    }
+    return input;
+  };
+
   auto update = [&](float dt) {
     if (currentState == MENU) {
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space)) {
-            menuSound.play(); // Play menu sound
-            bgMusic.play();   // Start background music
+        if (GameWindow::sampleInput().held(InputState::Fire)) {
+            pushEvent(events, GameEventType::MenuSelect); // Play menu sound
+            music.play(1, 0.25f); // Start background music
             currentState = PLAYING; 
             // Reset session just in case, or just start? 
             // Fresh start is better to ensure positions are correct.
-            session = std::make_unique<GameSession>((float)WIDTH, (float)HEIGHT);
+            startSession(1);
+        }
+    } else if ((currentState == PLAYING || currentState == DEATH_ANIM) &&
+               GameWindow::isRewindHeld()) {
+      // One tick back per tick
+      if (rewind.stepBack(stateBlob) && session->loadState(stateBlob)) {
+        if (recording) {
+          // The ticks up to the restored one still replay exactly: save
+          // them and record nothing more of this session
+          recordTrack.pop();
+          if (!recordPrefix.empty()) {
+            std::cerr << "Rewind used: recording of this session stops here"
+                      << std::endl;
+          }
+          flushRecording();
+          recordTrack.reset(recordTrack.level());
+          recording = false;
+        }
+        camera.setCenter(session->cameraCenter());
+        if (!session->player->isDead()) {
+          currentState = PLAYING;
         }
-    } else if (currentState == PLAYING) {
-      session->physics.step(dt);
-      session->player->handleInput(dt);
-      session->player->update(dt);
-      session->level->update(dt);
-      session->level->checkCollisions(*session->player);
-
-      // Check if player wants to shoot fireball
-      if (session->player->tryShootFireball()) {
-        float dir = session->player->isFacingRight() ? 1.0f : -1.0f;
-        sf::Vector2f pos = session->player->getPosition();
-        // Spawn fireball slightly in front of Mario
-        session->level->spawnFireball(pos.x + dir * 20.0f, pos.y - 10.0f, dir);
       }
+    } else if (currentState == PLAYING) {
+      session->step(dt, nextInput());
+      session->saveState(stateBlob);
+      rewind.push(stateBlob);
+      camera.setCenter(session->cameraCenter());
 
-      // Camera Follow with Constraints
-      // Block left movement (minCamX)
-      float minCamX = (float)WIDTH / 2.0f;
-      // Block right movement (maxCamX) - usar el ancho del nivel
-      float maxCamX = session->level->getLevelWidth() - (float)WIDTH / 2.0f;
-      float camX = std::max(session->player->getPosition().x, minCamX);
-      camX = std::min(camX, maxCamX); // Limitar al borde derecho
-
-      // Block down movement (maxCamY) - Ground is at bottom
-      float maxCamY = (float)HEIGHT / 2.0f;
-      float camY = std::min(session->player->getPosition().y, maxCamY);
-
-      camera.setCenter({camX, camY});
-
-      // Check Goal Reached
+      // Check Goal Reached (player is frozen by the session)
       if (session->level->isGoalReached()) {
-        // Freeze player when goal is reached
-        session->player->freeze();
-        
-        if (session->level->isGoalAnimComplete()) {
-          // If level 2 is complete, go directly to GAME_WON
-          if (currentLevel >= 2) {
+        if (session->isLevelComplete()) {
+          // If level 2 (or the stress level) is complete, go directly to GAME_WON
+          if (currentLevel >= 2 || stressMode) {
             currentState = GAME_WON;
-            bgMusic.stop(); // Stop music on win
+            music.stop(); // Stop music on win
             stateTimer = 5.0f; // Show "Juego Terminado" for 5 seconds
           } else {
             currentState = LEVEL_COMPLETE;
             stateTimer = 3.0f; // Show level screen for 3 seconds
+            music.prefetch(currentLevel + 1); // Ready before the screen ends
           }
         }
       }
 
-      // Check Death
+      // Check Death (falling into the void kills inside step())
       if (session->player->isDead()) {
         currentState = DEATH_ANIM;
-      } else if (session->player->getPosition().y > (float)HEIGHT + 50.0f) {
-        // Fell into void
-        session->player->die();
-        currentState = DEATH_ANIM;
       }
 
     } else if (currentState == DEATH_ANIM) {
-      // Continue physics for destruction/falling
-      session->physics.step(dt);
-      session->player->update(dt);
+      session->stepDeath(dt, nextInput());
+      session->saveState(stateBlob);
+      rewind.push(stateBlob);
 
       // Check Below Map
-      if (session->player->getPosition().y > (float)HEIGHT + 100.0f) {
+      if (session->isDeathComplete()) {
         lives--;
         if (lives > 0) {
           currentState = LIVES_SCREEN;
           stateTimer = 2.0f;
         } else {
           currentState = GAME_OVER;
-          bgMusic.stop(); // Stop music immediately
+          music.stop(0.1f); // Stop music immediately
           stateTimer = 3.0f;
         }
       }
@@ -212,14 +295,14 @@ int main() {
       stateTimer -= dt;
       if (stateTimer <= 0.0f) {
         // Reset Level (keep same level number)
-        session = std::make_unique<GameSession>((float)WIDTH, (float)HEIGHT, currentLevel);
+        startSession(currentLevel);
         currentState = PLAYING;
         camera.setCenter({(float)WIDTH / 2.0f, (float)HEIGHT / 2.0f});
       }
     } else if (currentState == GAME_OVER) {
       stateTimer -= dt;
       if (stateTimer <= 0.0f) {
-        bgMusic.stop(); // Stop music on game over
+        music.prefetch(1); // For the next game
         // Restart Game to Menu
         currentState = MENU;
         lives = 3;
@@ -238,7 +321,8 @@ int main() {
           currentLevel++;
           // Give 3 extra lives when reaching level 2
           lives += 3;
-          session = std::make_unique<GameSession>((float)WIDTH, (float)HEIGHT, currentLevel);
+          startSession(currentLevel);
+          music.play(currentLevel, 2.0f); // Crossfade to the level's track
           currentState = PLAYING;
           camera.setCenter({(float)WIDTH / 2.0f, (float)HEIGHT / 2.0f});
         }
@@ -248,6 +332,7 @@ int main() {
       if (stateTimer <= 0.0f) {
         // Return to menu after winning
         currentState = MENU;
+        music.prefetch(1); // For the next game
         lives = 3;
         currentLevel = 1;
         camera.setCenter({(float)WIDTH / 2.0f, (float)HEIGHT / 2.0f});
@@ -255,86 +340,55 @@ int main() {
     }
   };
 
-  auto render = [&]() {
-    if (currentState == MENU) {
-        window.window().setView(window.window().getDefaultView());
-        window.window().draw(menuSprite);
-    } else if (currentState == PLAYING || currentState == DEATH_ANIM) {
-      window.window().setView(camera);
-      session->level->draw(window.window());
-      session->player->draw(window.window());
+  // Runs on the simulation thread after the ticks of a frame: everything
+  // render() needs is copied into the snapshot
+  auto capture = [&](RenderSnapshot &snap) {
+    snap.screen = currentState;
+    snap.lives = lives;
+    snap.level = currentLevel;
+    snap.camera = camera;
+    snap.clear();
+    if (currentState == PLAYING || currentState == DEATH_ANIM) {
+      session->level->snapshot(snap);
+      session->player->snapshot(snap);
+    }
+  };
 
-      // Draw HUD
-      window.window().setView(window.window().getDefaultView());
-      window.window().draw(helmetSprite); // Draw helmet icon
-      std::string vidasText = (lives == 1) ? "Vida: " : "Vidas: ";
-      hudText.setString(vidasText + std::to_string(lives));
-      window.window().draw(hudText);
+  // Runs on the render thread: only the snapshot, the HUD and the screen
+  // sprites (never touched by update) may be used here
+  auto render = [&](const RenderSnapshot &snap, sf::RenderTarget &target) {
+    State screen = static_cast<State>(snap.screen);
+    if (screen == MENU) {
+        target.setView(target.getDefaultView());
+        target.draw(menuSprite);
+    } else if (screen == PLAYING || screen == DEATH_ANIM) {
+      snap.draw(target, &staticCache);
+      hud.draw(target, Hud::Screen::Playing, snap.lives);
     } else {
       // Draw Black Screen with UI
-      window.window().setView(window.window().getDefaultView());
+      target.setView(target.getDefaultView());
 
-      sf::RectangleShape blackScreen(sf::Vector2f((float)WIDTH, (float)HEIGHT));
-      blackScreen.setFillColor(sf::Color::Black);
-      
       // GAME_WON shows Final.png as background, GAME_OVER shows gameover.png
-      if (currentState == GAME_WON) {
-        window.window().draw(finalSprite);
-      } else if (currentState == GAME_OVER) {
-        window.window().draw(gameOverSprite);
+      // (GAME_OVER already has full image, no text for it)
+      if (screen == GAME_WON) {
+        target.draw(finalSprite);
+        hud.draw(target, Hud::Screen::Won, 0);
+      } else if (screen == GAME_OVER) {
+        target.draw(gameOverSprite);
       } else {
-        window.window().draw(blackScreen);
-      }
-
-      // GAME_OVER already has full image, skip text for it
-      if (currentState == GAME_OVER) {
-        // Do nothing, image is already drawn
-      } else {
-        if (currentState == LIVES_SCREEN) {
-          std::string vidasLabel = (lives == 1) ? " Vida" : " Vidas";
-          uiText.setString(std::to_string(lives) + vidasLabel);
-        } else if (currentState == LEVEL_COMPLETE) {
-          uiText.setString("Nivel " + std::to_string(currentLevel + 1));
-        } else if (currentState == GAME_WON) {
-          uiText.setString("Juego Terminado");
-        }
-
-        // Center Text
-        sf::FloatRect textBounds = uiText.getLocalBounds();
-        uiText.setOrigin({textBounds.position.x + textBounds.size.x / 2.0f,
-                          textBounds.position.y + textBounds.size.y / 2.0f});
-        uiText.setPosition({(float)WIDTH / 2.0f, (float)HEIGHT / 2.0f});
-
-        window.window().draw(uiText);
-        
-        // Draw "Gracias por Jugar" below main text on GAME_WON
-        if (currentState == GAME_WON) {
-          sf::Text thanksText(font);
-          thanksText.setCharacterSize(30);
-          thanksText.setFillColor(sf::Color::White);
-          thanksText.setString("Gracias por Jugar");
-          sf::FloatRect thanksBounds = thanksText.getLocalBounds();
-          thanksText.setOrigin({thanksBounds.position.x + thanksBounds.size.x / 2.0f,
-                                thanksBounds.position.y + thanksBounds.size.y / 2.0f});
-          thanksText.setPosition({(float)WIDTH / 2.0f, (float)HEIGHT / 2.0f + 60.0f});
-          window.window().draw(thanksText);
-        }
-        
-        // Draw helmet icon next to lives text on LIVES_SCREEN
-        if (currentState == LIVES_SCREEN) {
-          sf::Sprite centeredHelmet(helmetTexture);
-          centeredHelmet.setScale({0.8f, 0.8f}); // Larger for center screen
-          // Position to the left of the text
-          float helmetX = (float)WIDTH / 2.0f - textBounds.size.x / 2.0f - 60.0f;
-          float helmetY = (float)HEIGHT / 2.0f - 25.0f;
-          centeredHelmet.setPosition({helmetX, helmetY});
-          window.window().draw(centeredHelmet);
+        target.clear(sf::Color::Black);
+        if (screen == LIVES_SCREEN) {
+          hud.draw(target, Hud::Screen::Lives, snap.lives);
+        } else if (screen == LEVEL_COMPLETE) {
+          hud.draw(target, Hud::Screen::Level, snap.level + 1);
         }
       }
     }
   };
 
-  window.run(update, render);
+  window.run(update, capture, render);
+  flushRecording();
+  std::cerr << window.pacer().report();
 
   return 0;
 }
@@ -0,0 +1,62 @@
+// Asset baker: writes every BakedAsset (pre-scaled sprite strips) to disk.
+// Runs at build time (make assets) so the game loads small textures sized
+// for the screen instead of sampling large crops at draw time. Needs no
+// window or GPU: images are resampled on the CPU.
+//
+// Usage: bake_assets [--out DIR] [--list]
+//
+// Run from the repository root (source paths are relative to it). --out
+// defaults to assets/baked, where TextureCache::getBaked looks; --list only
+// prints the assets and their sizes.
+
+#include "BakedAssets.hpp"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+int main(int argc, char **argv) {
+  std::string outDir = "assets/baked";
+  bool listOnly = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      outDir = argv[++i];
+    } else if (std::strcmp(argv[i], "--list") == 0) {
+      listOnly = true;
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [--out DIR] [--list]"
+                << std::endl;
+      return 2;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::create_directories(outDir, error);
+  if (error) {
+    std::cerr << "Error creating " << outDir << ": " << error.message()
+              << std::endl;
+    return 1;
+  }
+
+  int failures = 0;
+  for (const BakedAsset &asset : BakedAsset::all()) {
+    std::cout << asset.name << ": " << asset.frames.size() << " frame(s) of "
+              << asset.source << " -> " << asset.frameSize.x << "x"
+              << asset.frameSize.y << std::endl;
+    if (listOnly) {
+      continue;
+    }
+    sf::Image source;
+    if (!source.loadFromFile(asset.source)) {
+      std::cerr << "Error loading " << asset.source << std::endl;
+      ++failures;
+      continue;
+    }
+    std::string path = outDir + "/" + asset.name + ".png";
+    if (!asset.bake(source).saveToFile(path)) {
+      std::cerr << "Error writing " << path << std::endl;
+      ++failures;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
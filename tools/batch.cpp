@@ -0,0 +1,166 @@
+// Parallel batch runner.
+// Plays many independent GameSessions, one job per session on a thread
+// pool, with no window, GPU or audio device. Reports outcomes, per-session
+// timings and the aggregate simulation throughput, so level changes can be
+// checked against thousands of runs and core scaling can be measured.
+//
+// Usage: mario_batch [--sessions N] [--threads N] [--level N]
+//                    [--script FILE] [--seed S] [--max-ticks N]
+//                    [--record-dir DIR] [--verbose]
+//
+// Without --script every session gets its own random input (seeded from
+// --seed and the session index, so a batch is reproducible). With --record-dir
+// each session's input is saved as DIR/session-<i>.rec for the game's
+// --replay option or mario_headless --replay.
+
+#include "GameSession.hpp"
+#include "InputTrack.hpp"
+#include "TextureCache.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct SessionResult {
+  RunResult run;
+  double millis;
+};
+
+double percentile(std::vector<double> sorted, double p) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int sessions = 1000;
+  size_t threads = 0;
+  int levelNumber = 1;
+  std::string scriptPath;
+  unsigned int seed = 1;
+  unsigned long maxTicks = 60 * 60 * 5; // 5 minutes of game time
+  std::string recordDir;
+  bool verbose = false;
+
+  for (int i = 1; i < argc; ++i) {
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(argv[i], "--sessions") == 0 && hasValue) {
+      sessions = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+      threads = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--level") == 0 && hasValue) {
+      levelNumber = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--script") == 0 && hasValue) {
+      scriptPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+      seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(argv[i], "--max-ticks") == 0 && hasValue) {
+      maxTicks = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--record-dir") == 0 && hasValue) {
+      recordDir = argv[++i];
+    } else if (std::strcmp(argv[i], "--verbose") == 0) {
+      verbose = true;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--sessions N] [--threads N] [--level N] [--script FILE]"
+                   " [--seed S] [--max-ticks N] [--record-dir DIR] [--verbose]"
+                << std::endl;
+      return 2;
+    }
+  }
+  if (sessions <= 0) {
+    return 0;
+  }
+
+  InputTrack script;
+  if (!scriptPath.empty() && !script.loadScript(scriptPath)) {
+    return 1;
+  }
+
+  // No textures, no GL context, no audio device
+  TextureCache::setHeadless(true);
+
+  std::vector<SessionResult> results(sessions);
+  auto start = std::chrono::steady_clock::now();
+  size_t workerCount = 0;
+  {
+    ThreadPool pool(threads);
+    workerCount = pool.size();
+    for (int index = 0; index < sessions; ++index) {
+      pool.submit([&, index]() {
+        // Each job writes only its own result slot
+        InputTrack track;
+        if (scriptPath.empty()) {
+          std::mt19937 rng(seed + static_cast<unsigned int>(index));
+          track = InputTrack::randomized(levelNumber, rng, maxTicks);
+        }
+        const InputTrack &input = scriptPath.empty() ? track : script;
+
+        InputTrack record;
+        record.reset(levelNumber);
+        auto sessionStart = std::chrono::steady_clock::now();
+        RunResult run = runSession(levelNumber, input, maxTicks,
+                                   recordDir.empty() ? nullptr : &record);
+        std::chrono::duration<double, std::milli> millis =
+            std::chrono::steady_clock::now() - sessionStart;
+        results[index] = {run, millis.count()};
+
+        if (!recordDir.empty()) {
+          record.saveToFile(recordDir + "/session-" + std::to_string(index) +
+                            ".rec");
+        }
+      });
+    }
+    pool.wait();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  unsigned long totalTicks = 0;
+  int goals = 0, deaths = 0, timeouts = 0;
+  std::vector<double> timings;
+  timings.reserve(results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    const SessionResult &result = results[i];
+    totalTicks += result.run.ticks;
+    timings.push_back(result.millis);
+    switch (result.run.outcome) {
+    case RunOutcome::Goal: ++goals; break;
+    case RunOutcome::Death: ++deaths; break;
+    case RunOutcome::Timeout: ++timeouts; break;
+    }
+    if (verbose) {
+      std::cout << "session " << i << ": " << outcomeName(result.run.outcome)
+                << " after " << result.run.ticks
+                << " ticks, x=" << result.run.finalX << ", " << result.millis
+                << " ms" << std::endl;
+    }
+  }
+  std::sort(timings.begin(), timings.end());
+
+  double seconds = elapsed.count();
+  std::cout << sessions << " sessions on " << workerCount << " threads, level "
+            << levelNumber << std::endl;
+  std::cout << "outcomes: " << goals << " goal, " << deaths << " death, "
+            << timeouts << " timeout" << std::endl;
+  std::cout << "session ms: min " << timings.front() << ", median "
+            << percentile(timings, 0.5) << ", p95 "
+            << percentile(timings, 0.95) << ", max " << timings.back()
+            << std::endl;
+  std::cout << totalTicks << " ticks in " << seconds << " s ("
+            << (seconds > 0.0 ? totalTicks / seconds : 0.0) << " ticks/s, "
+            << (seconds > 0.0 ? totalTicks / seconds / workerCount : 0.0)
+            << " ticks/s per thread)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,376 @@
+// Microbenchmarks for the simulation and draw paths.
+// Times Physics::step, Level::update, Level::checkCollisions,
+// Player::updateAnimation, a whole GameSession::step, level construction,
+// the particle pool (ParticleSystem::update and its vertex array) and (with
+// --draw) Level+Player drawing into an offscreen RenderTexture.
+// Every benchmark runs for each combination of the parameter lists and the
+// results are written as JSON, so a change can be measured before and after.
+//
+// Usage: mario_bench [--level N] [--enemies N,N,...] [--fireballs N,N,...]
+//                    [--width PX,PX,...] [--particles N,N,...] [--samples N]
+//                    [--draw] [--json FILE]
+//
+// A --width other than 0 replaces the level with an empty generated level
+// of that width (StressLevelSpec with no content, at least
+// StressLevelSpec::MIN_WIDTH), so the cost of the level size itself shows
+// up. Extra enemies are instantiated right away, spread
+// over the level on the ground (Level::spawnEnemy); fireballs are topped up
+// to the requested count before every sample, outside the timed region.
+// The particle pool is filled to --particles live particles the same way.
+// Times are per call, in microseconds. --draw needs a GL context and the
+// assets directory, so run it from the repository root on a machine with a
+// display.
+
+#include "GameSession.hpp"
+#include "ParticleSystem.hpp"
+#include "TextureCache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const float VIEW_WIDTH = 800.0f;
+const float VIEW_HEIGHT = 600.0f;
+
+struct Config {
+  int level;
+  int width; // 0 = the level's own width
+  int enemies;
+  int fireballs;
+  int particles = 0;
+};
+
+struct Result {
+  std::string name;
+  Config config;
+  size_t samples;
+  size_t liveEnemies;
+  double meanUs, medianUs, p95Us, minUs;
+};
+
+std::vector<int> parseList(const char *text) {
+  std::vector<int> values;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      values.push_back(std::max(0, std::atoi(item.c_str())));
+    }
+  }
+  return values;
+}
+
+// Per-call microseconds from per-sample durations
+Result summarize(const std::string &name, const Config &config,
+                 std::vector<double> micros, size_t liveEnemies) {
+  Result result{name, config, micros.size(), liveEnemies, 0.0, 0.0, 0.0, 0.0};
+  if (micros.empty()) {
+    return result;
+  }
+  std::sort(micros.begin(), micros.end());
+  double sum = 0.0;
+  for (double value : micros) {
+    sum += value;
+  }
+  result.meanUs = sum / micros.size();
+  result.medianUs = micros[micros.size() / 2];
+  result.p95Us = micros[std::min(micros.size() - 1,
+                                 static_cast<size_t>(micros.size() * 0.95))];
+  result.minUs = micros.front();
+  return result;
+}
+
+class Stopwatch {
+public:
+  void start() { m_start = std::chrono::steady_clock::now(); }
+  double elapsedUs() const {
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now() - m_start)
+        .count();
+  }
+
+private:
+  std::chrono::steady_clock::time_point m_start;
+};
+
+std::unique_ptr<GameSession> createSession(const Config &config) {
+  if (config.width == 0) {
+    return std::make_unique<GameSession>(VIEW_WIDTH, VIEW_HEIGHT,
+                                         config.level);
+  }
+  StressLevelSpec spec;
+  spec.width = static_cast<float>(config.width);
+  spec.enemies = spec.platforms = spec.hazards = spec.blocks = 0;
+  return std::make_unique<GameSession>(VIEW_WIDTH, VIEW_HEIGHT, spec);
+}
+
+std::unique_ptr<GameSession> makeSession(const Config &config) {
+  std::unique_ptr<GameSession> session = createSession(config);
+  Level &level = *session->level;
+  float width = level.getLevelWidth();
+  for (int i = 0; i < config.enemies; ++i) {
+    // Spread evenly, skipping the player's start area, alternating kinds
+    float x = 300.0f + (width - 500.0f) * (i + 0.5f) / config.enemies;
+    level.spawnEnemy(i % 4 == 3 ? Level::EnemySpawn::Kind::Koopa
+                                : Level::EnemySpawn::Kind::Goomba,
+                     x, level.groundY() - 40.0f);
+  }
+  return session;
+}
+
+void refillFireballs(GameSession &session, int count, int &next) {
+  Level &level = *session.level;
+  int span = std::max(1, static_cast<int>(level.getLevelWidth()) - 400);
+  while (level.fireballCount() < static_cast<size_t>(count)) {
+    // Deterministic scatter over the level
+    float x = 200.0f + static_cast<float>((next * 397) % span);
+    level.spawnFireball(x, level.groundY() - 120.0f, next % 2 ? 1.0f : -1.0f);
+    ++next;
+  }
+}
+
+// The phases of GameSession::step, timed one by one on the same world
+void benchStep(const Config &config, size_t samples,
+               std::vector<Result> &results) {
+  std::unique_ptr<GameSession> session = makeSession(config);
+  const float dt = GameSession::TICK_DT;
+  InputState idle;
+  int fireballSeed = 0;
+
+  std::vector<double> physics, update, collisions, animation;
+  Stopwatch watch;
+  for (size_t i = 0; i < samples; ++i) {
+    refillFireballs(*session, config.fireballs, fireballSeed);
+
+    watch.start();
+    session->physics.step(dt);
+    physics.push_back(watch.elapsedUs());
+
+    session->player->handleInput(dt, idle);
+    session->player->update(dt, idle);
+
+    watch.start();
+    session->level->update(dt);
+    update.push_back(watch.elapsedUs());
+
+    watch.start();
+    session->level->checkCollisions(*session->player);
+    collisions.push_back(watch.elapsedUs());
+
+    // Too short to time one call: average 100
+    watch.start();
+    for (int call = 0; call < 100; ++call) {
+      session->player->updateAnimation(dt);
+    }
+    animation.push_back(watch.elapsedUs() / 100.0);
+  }
+  size_t live = session->level->getEnemies().size();
+  results.push_back(summarize("physics_step", config, physics, live));
+  results.push_back(summarize("level_update", config, update, live));
+  results.push_back(
+      summarize("level_check_collisions", config, collisions, live));
+  results.push_back(
+      summarize("player_update_animation", config, animation, live));
+
+  // The whole tick, spawning and despawning included, on a fresh world
+  session = makeSession(config);
+  std::vector<double> step;
+  for (size_t i = 0; i < samples; ++i) {
+    refillFireballs(*session, config.fireballs, fireballSeed);
+    watch.start();
+    session->step(dt, idle);
+    step.push_back(watch.elapsedUs());
+  }
+  results.push_back(summarize("session_step", config, step,
+                              session->level->getEnemies().size()));
+}
+
+void benchConstruction(const Config &config, size_t samples,
+                       std::vector<Result> &results) {
+  std::vector<double> micros;
+  Stopwatch watch;
+  for (size_t i = 0; i < samples; ++i) {
+    watch.start();
+    std::unique_ptr<GameSession> session = createSession(config);
+    micros.push_back(watch.elapsedUs());
+  }
+  results.push_back(summarize("level_construction", config, micros, 0));
+}
+
+// Bursts over the level's width until the pool holds 'count' particles
+void refillParticles(ParticleSystem &particles, std::size_t count) {
+  float x = 0.0f;
+  while (particles.size() < count &&
+         particles.burst(ParticleSystem::Burst::Sparks, {x, 300.0f}) > 0) {
+    x = x < 6000.0f ? x + 37.0f : 0.0f;
+  }
+}
+
+// One pool, kept full: the update kernel and the vertex array rebuild
+void benchParticles(const Config &config, size_t samples,
+                    std::vector<Result> &results) {
+  size_t count = static_cast<size_t>(config.particles);
+  ParticleSystem particles(count);
+  std::vector<double> update, vertices;
+  Stopwatch watch;
+  for (size_t i = 0; i < samples; ++i) {
+    refillParticles(particles, count);
+
+    watch.start();
+    particles.update(GameSession::TICK_DT);
+    update.push_back(watch.elapsedUs());
+
+    watch.start();
+    particles.vertices();
+    vertices.push_back(watch.elapsedUs());
+  }
+  results.push_back(summarize("particles_update", config, update, 0));
+  results.push_back(summarize("particles_vertices", config, vertices, 0));
+}
+
+// Camera sweeps the level so every part of it gets drawn
+bool benchDraw(const Config &config, size_t samples,
+               std::vector<Result> &results) {
+  sf::RenderTexture target;
+  if (!target.resize({static_cast<unsigned int>(VIEW_WIDTH),
+                      static_cast<unsigned int>(VIEW_HEIGHT)})) {
+    std::cerr << "Error creating offscreen render target" << std::endl;
+    return false;
+  }
+  std::unique_ptr<GameSession> session = makeSession(config);
+  int fireballSeed = 0;
+  refillFireballs(*session, config.fireballs, fireballSeed);
+  session->physics.step(GameSession::TICK_DT);
+  session->level->update(GameSession::TICK_DT);
+
+  float width = session->level->getLevelWidth();
+  sf::View view({VIEW_WIDTH / 2.0f, VIEW_HEIGHT / 2.0f},
+                {VIEW_WIDTH, VIEW_HEIGHT});
+  std::vector<double> micros;
+  Stopwatch watch;
+  for (size_t i = 0; i < samples; ++i) {
+    float x = VIEW_WIDTH / 2.0f +
+              (width - VIEW_WIDTH) * static_cast<float>(i % 100) / 100.0f;
+    view.setCenter({x, session->cameraCenter().y});
+    watch.start();
+    target.setView(view);
+    target.clear(sf::Color(92, 148, 252));
+    session->level->draw(target);
+    session->player->draw(target);
+    target.display();
+    micros.push_back(watch.elapsedUs());
+  }
+  results.push_back(summarize("draw_offscreen", config, micros,
+                              session->level->getEnemies().size()));
+  return true;
+}
+
+void writeJson(std::ostream &out, const std::vector<Result> &results) {
+  out << "{\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result &r = results[i];
+    out << "    {\"name\": \"" << r.name << "\", \"level\": " << r.config.level
+        << ", \"width\": " << r.config.width
+        << ", \"enemies\": " << r.config.enemies
+        << ", \"fireballs\": " << r.config.fireballs
+        << ", \"particles\": " << r.config.particles
+        << ", \"samples\": " << r.samples
+        << ", \"live_enemies\": " << r.liveEnemies
+        << ", \"mean_us\": " << r.meanUs << ", \"median_us\": " << r.medianUs
+        << ", \"p95_us\": " << r.p95Us << ", \"min_us\": " << r.minUs << "}"
+        << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int levelNumber = 1;
+  std::vector<int> enemyCounts{0, 100, 1000};
+  std::vector<int> fireballCounts{0, 50};
+  std::vector<int> widths{0};
+  std::vector<int> particleCounts{1000, 50000};
+  size_t samples = 600;
+  bool draw = false;
+  std::string jsonPath;
+
+  for (int i = 1; i < argc; ++i) {
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(argv[i], "--level") == 0 && hasValue) {
+      levelNumber = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--enemies") == 0 && hasValue) {
+      enemyCounts = parseList(argv[++i]);
+    } else if (std::strcmp(argv[i], "--fireballs") == 0 && hasValue) {
+      fireballCounts = parseList(argv[++i]);
+    } else if (std::strcmp(argv[i], "--width") == 0 && hasValue) {
+      widths = parseList(argv[++i]);
+      for (int width : widths) {
+        if (width != 0 && width < StressLevelSpec::MIN_WIDTH) {
+          std::cerr << "Error: --width must be 0 or at least "
+                    << StressLevelSpec::MIN_WIDTH << std::endl;
+          return 2;
+        }
+      }
+    } else if (std::strcmp(argv[i], "--particles") == 0 && hasValue) {
+      particleCounts = parseList(argv[++i]);
+    } else if (std::strcmp(argv[i], "--samples") == 0 && hasValue) {
+      samples = std::max(1UL, std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(argv[i], "--draw") == 0) {
+      draw = true;
+    } else if (std::strcmp(argv[i], "--json") == 0 && hasValue) {
+      jsonPath = argv[++i];
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--level N] [--enemies N,N,...] [--fireballs N,N,...]"
+                   " [--width PX,PX,...] [--particles N,N,...] [--samples N]"
+                   " [--draw] [--json FILE]"
+                << std::endl;
+      return 2;
+    }
+  }
+
+  // Drawing needs the real textures; everything else runs headless
+  TextureCache::setHeadless(!draw);
+
+  std::vector<Result> results;
+  for (int particles : particleCounts) {
+    benchParticles({levelNumber, 0, 0, 0, particles}, samples, results);
+  }
+  for (int width : widths) {
+    benchConstruction({levelNumber, width, 0, 0},
+                      std::min<size_t>(samples, 50), results);
+    for (int enemies : enemyCounts) {
+      for (int fireballs : fireballCounts) {
+        Config config{levelNumber, width, enemies, fireballs};
+        std::cerr << "level " << levelNumber << ", width " << width << ", "
+                  << enemies << " enemies, " << fireballs << " fireballs"
+                  << std::endl;
+        benchStep(config, samples, results);
+        if (draw && !benchDraw(config, samples, results)) {
+          return 1;
+        }
+      }
+    }
+  }
+
+  if (jsonPath.empty()) {
+    writeJson(std::cout, results);
+    return 0;
+  }
+  std::ofstream file(jsonPath);
+  if (!file) {
+    std::cerr << "Error writing " << jsonPath << std::endl;
+    return 1;
+  }
+  writeJson(file, results);
+  return 0;
+}
@@ -0,0 +1,439 @@
+// Input fuzzer.
+// Plays thousands of generated input tracks against a level on a thread
+// pool and flags runs that expose level or physics bugs:
+//   stuck   - holding right without gaining any x for --stuck-seconds
+//   clip    - the player ends up inside solid geometry
+//   below   - the player is alive below the bottom of the world
+//   growth  - more enemies or items than the level can ever produce
+// Each finding is shrunk to a short track that still reproduces it and saved
+// as OUT/level<N>-<kind>-<i>.rec, which the game (--replay) and
+// mario_headless (--replay) play back tick for tick.
+//
+// Usage: mario_fuzz [--level N] [--mode random|genetic] [--runs N]
+//                   [--generations N] [--population N] [--threads N]
+//                   [--seed S] [--max-ticks N] [--stuck-seconds S]
+//                   [--out DIR]
+//
+// 'random' plays --runs independent random tracks. 'genetic' evolves a
+// population towards the right (fitness = furthest x, goal counts double),
+// which reaches the late parts of a level far more often than random play.
+
+#include "GameSession.hpp"
+#include "InputTrack.hpp"
+#include "TextureCache.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+enum class Finding { None, Stuck, Clip, BelowWorld, EntityGrowth };
+
+const char *findingName(Finding finding) {
+  switch (finding) {
+  case Finding::None: return "none";
+  case Finding::Stuck: return "stuck";
+  case Finding::Clip: return "clip";
+  case Finding::BelowWorld: return "below";
+  case Finding::EntityGrowth: return "growth";
+  }
+  return "?";
+}
+
+struct Limits {
+  unsigned long maxTicks;
+  unsigned long stuckTicks;
+};
+
+struct Evaluation {
+  Finding finding = Finding::None;
+  RunOutcome outcome = RunOutcome::Timeout;
+  unsigned long ticks = 0; // ticks played (up to and including the finding)
+  float maxX = 0.0f;
+  float x = 0.0f; // player x when the run stopped
+};
+
+const float VIEW_WIDTH = 800.0f;
+const float VIEW_HEIGHT = 600.0f;
+
+bool pushesRight(InputState input) {
+  return input.held(InputState::Right) && !input.held(InputState::Left);
+}
+
+// Plays 'track' on a fresh session with the same rules as runSession, plus
+// the bug checks after every tick
+Evaluation evaluate(int levelNumber, const InputTrack &track,
+                    const Limits &limits) {
+  GameSession session(VIEW_WIDTH, VIEW_HEIGHT, levelNumber);
+  InputPlayback playback(track);
+  const Level &level = *session.level;
+  // Enemies only come from the spawn list and items only from blocks
+  size_t enemyBudget = level.getEnemies().size() + level.pendingSpawnCount();
+  size_t itemBudget = level.blockCount();
+
+  Evaluation result;
+  result.maxX = -1.0e9f;
+  unsigned long pushingSinceProgress = 0;
+
+  for (unsigned long tick = 0; tick < limits.maxTicks; ++tick) {
+    InputState input = playback.next();
+    session.step(GameSession::TICK_DT, input);
+
+    sf::Vector2f pos = session.player->getPosition();
+    result.ticks = tick + 1;
+    result.x = pos.x;
+    auto flag = [&](Finding finding) {
+      result.finding = finding;
+      return result;
+    };
+
+    if (!session.player->isDead() && pos.y > VIEW_HEIGHT + 50.0f) {
+      return flag(Finding::BelowWorld); // step() should have killed it
+    }
+    if (session.player->isDead()) {
+      result.outcome = RunOutcome::Death;
+      return result;
+    }
+    // getPosition() is the body's centre: test it and a point just above
+    // the feet, so sinking into the floor is caught too
+    float feetY = pos.y + session.player->getHalfHeight() - 2.0f;
+    if (level.isInsideSolid(pos) || level.isInsideSolid({pos.x, feetY})) {
+      return flag(Finding::Clip);
+    }
+    if (level.getEnemies().size() + level.pendingSpawnCount() > enemyBudget ||
+        level.itemCount() > itemBudget) {
+      return flag(Finding::EntityGrowth);
+    }
+    if (session.isLevelComplete()) {
+      result.outcome = RunOutcome::Goal;
+      return result;
+    }
+
+    // Only ticks that push right count, so standing still is not "stuck"
+    if (pos.x > result.maxX + 1.0f) {
+      result.maxX = pos.x;
+      pushingSinceProgress = 0;
+    } else if (pushesRight(input) && !session.level->isGoalReached() &&
+               ++pushingSinceProgress >= limits.stuckTicks) {
+      return flag(Finding::Stuck);
+    }
+  }
+  return result;
+}
+
+// First 'ticks' ticks of 'track'
+InputTrack truncated(const InputTrack &track, unsigned long ticks) {
+  InputTrack out;
+  out.reset(track.level());
+  for (const InputTrack::Run &run : track.runs()) {
+    if (ticks == 0) {
+      break;
+    }
+    std::uint32_t length =
+        static_cast<std::uint32_t>(std::min<unsigned long>(run.ticks, ticks));
+    out.append(run.input, length);
+    ticks -= length;
+  }
+  return out;
+}
+
+InputTrack fromRuns(int levelNumber, const std::vector<InputTrack::Run> &runs) {
+  InputTrack out;
+  out.reset(levelNumber);
+  for (const InputTrack::Run &run : runs) {
+    out.append(run.input, run.ticks);
+  }
+  return out;
+}
+
+// Delta debugging over runs: drops chunks of runs (halving the chunk size
+// down to single runs), then tries releasing every remaining run's buttons,
+// keeping each change only if the same kind of finding still happens
+InputTrack minimize(const InputTrack &track, const Evaluation &found,
+                    const Limits &limits) {
+  int levelNumber = track.level();
+  auto reproduces = [&](const std::vector<InputTrack::Run> &runs) {
+    return evaluate(levelNumber, fromRuns(levelNumber, runs), limits).finding ==
+           found.finding;
+  };
+
+  std::vector<InputTrack::Run> best = truncated(track, found.ticks).runs();
+  for (size_t chunk = best.size() / 2; chunk >= 1; chunk /= 2) {
+    size_t start = 0;
+    while (start < best.size() && best.size() > 1) {
+      std::vector<InputTrack::Run> candidate;
+      candidate.reserve(best.size());
+      candidate.insert(candidate.end(), best.begin(), best.begin() + start);
+      candidate.insert(candidate.end(),
+                       best.begin() + std::min(start + chunk, best.size()),
+                       best.end());
+      if (reproduces(candidate)) {
+        best = std::move(candidate);
+      } else {
+        start += chunk;
+      }
+    }
+  }
+  for (size_t i = 0; i < best.size(); ++i) {
+    if (best[i].input.buttons == 0) {
+      continue;
+    }
+    std::vector<InputTrack::Run> candidate = best;
+    candidate[i].input.buttons = 0;
+    if (reproduces(candidate)) {
+      best = std::move(candidate);
+    }
+  }
+  // The last run only needs to last until the finding
+  return truncated(fromRuns(levelNumber, best),
+                   evaluate(levelNumber, fromRuns(levelNumber, best), limits)
+                       .ticks);
+}
+
+InputState randomInput(std::mt19937 &rng) {
+  std::uniform_int_distribution<int> buttons(0, 31);
+  InputState input;
+  input.buttons = static_cast<std::uint8_t>(buttons(rng));
+  return input;
+}
+
+// Mutation for the genetic mode: re-rolls, stretches or inserts runs
+InputTrack mutate(const InputTrack &track, std::mt19937 &rng) {
+  std::vector<InputTrack::Run> runs = track.runs();
+  std::uniform_int_distribution<int> op(0, 2);
+  std::uniform_int_distribution<std::uint32_t> hold(4, 45);
+  int changes = std::uniform_int_distribution<int>(1, 4)(rng);
+  for (int i = 0; i < changes && !runs.empty(); ++i) {
+    size_t at = std::uniform_int_distribution<size_t>(0, runs.size() - 1)(rng);
+    switch (op(rng)) {
+    case 0: runs[at].input = randomInput(rng); break;
+    case 1:
+      runs[at].ticks = std::max<std::uint32_t>(
+          1, static_cast<std::uint32_t>(
+                 runs[at].ticks *
+                 std::uniform_real_distribution<float>(0.5f, 1.5f)(rng)));
+      break;
+    case 2: runs.insert(runs.begin() + at, {hold(rng), randomInput(rng)}); break;
+    }
+  }
+  return fromRuns(track.level(), runs);
+}
+
+// One-point crossover at a run boundary
+InputTrack crossover(const InputTrack &a, const InputTrack &b,
+                     std::mt19937 &rng) {
+  const std::vector<InputTrack::Run> &left = a.runs();
+  const std::vector<InputTrack::Run> &right = b.runs();
+  if (left.empty() || right.empty()) {
+    return a;
+  }
+  size_t cut = std::uniform_int_distribution<size_t>(0, left.size() - 1)(rng);
+  size_t from = std::min(cut, right.size() - 1);
+  std::vector<InputTrack::Run> runs(left.begin(), left.begin() + cut);
+  runs.insert(runs.end(), right.begin() + from, right.end());
+  return fromRuns(a.level(), runs);
+}
+
+float fitness(const Evaluation &eval) {
+  return eval.outcome == RunOutcome::Goal ? eval.maxX * 2.0f : eval.maxX;
+}
+
+struct Failure {
+  InputTrack track;
+  Evaluation eval;
+};
+
+// Keeps one failure per kind and 128px stretch of the level, so a single
+// bad spot is not reported (and minimized) hundreds of times
+class FailureLog {
+public:
+  void add(const InputTrack &track, const Evaluation &eval) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto key = std::make_pair(eval.finding, static_cast<int>(eval.x / 128.0f));
+    if (m_failures.count(key) == 0) {
+      m_failures[key] = {track, eval};
+    }
+  }
+
+  std::vector<Failure> all() const {
+    std::vector<Failure> out;
+    for (const auto &entry : m_failures) {
+      out.push_back(entry.second);
+    }
+    return out;
+  }
+
+private:
+  mutable std::mutex m_mutex;
+  std::map<std::pair<Finding, int>, Failure> m_failures;
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int levelNumber = 1;
+  std::string mode = "random";
+  int runs = 2000;
+  int generations = 50;
+  int population = 128;
+  size_t threads = 0;
+  unsigned int seed = 1;
+  Limits limits{60 * 60 * 3, 60 * 10}; // 3 minutes per run, 10 s stuck
+  std::string outDir = ".";
+
+  for (int i = 1; i < argc; ++i) {
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(argv[i], "--level") == 0 && hasValue) {
+      levelNumber = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--mode") == 0 && hasValue) {
+      mode = argv[++i];
+    } else if (std::strcmp(argv[i], "--runs") == 0 && hasValue) {
+      runs = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--generations") == 0 && hasValue) {
+      generations = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--population") == 0 && hasValue) {
+      population = std::max(4, std::atoi(argv[++i]));
+    } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+      threads = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+      seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(argv[i], "--max-ticks") == 0 && hasValue) {
+      limits.maxTicks = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--stuck-seconds") == 0 && hasValue) {
+      limits.stuckTicks = static_cast<unsigned long>(
+          std::atof(argv[++i]) / GameSession::TICK_DT);
+    } else if (std::strcmp(argv[i], "--out") == 0 && hasValue) {
+      outDir = argv[++i];
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--level N] [--mode random|genetic] [--runs N]"
+                   " [--generations N] [--population N] [--threads N]"
+                   " [--seed S] [--max-ticks N] [--stuck-seconds S]"
+                   " [--out DIR]"
+                << std::endl;
+      return 2;
+    }
+  }
+  if (mode != "random" && mode != "genetic") {
+    std::cerr << "Unknown mode: " << mode << std::endl;
+    return 2;
+  }
+  limits.stuckTicks = std::max(1UL, limits.stuckTicks);
+
+  TextureCache::setHeadless(true);
+
+  FailureLog log;
+  unsigned long played = 0;
+  float bestX = 0.0f;
+  int goals = 0;
+  auto start = std::chrono::steady_clock::now();
+  ThreadPool pool(threads);
+
+  if (mode == "random") {
+    std::vector<Evaluation> results(runs);
+    for (int index = 0; index < runs; ++index) {
+      pool.submit([&, index]() {
+        std::mt19937 rng(seed + static_cast<unsigned int>(index));
+        InputTrack track =
+            InputTrack::randomized(levelNumber, rng, limits.maxTicks);
+        results[index] = evaluate(levelNumber, track, limits);
+        if (results[index].finding != Finding::None) {
+          log.add(track, results[index]);
+        }
+      });
+    }
+    pool.wait();
+    for (const Evaluation &eval : results) {
+      played += eval.ticks;
+      bestX = std::max(bestX, eval.maxX);
+      goals += eval.outcome == RunOutcome::Goal;
+    }
+  } else {
+    std::mt19937 rng(seed);
+    std::vector<InputTrack> tracks(population);
+    for (InputTrack &track : tracks) {
+      track = InputTrack::randomized(levelNumber, rng, limits.maxTicks);
+    }
+
+    for (int generation = 0; generation < generations; ++generation) {
+      std::vector<Evaluation> results(tracks.size());
+      for (size_t index = 0; index < tracks.size(); ++index) {
+        pool.submit([&, index]() {
+          results[index] = evaluate(levelNumber, tracks[index], limits);
+          if (results[index].finding != Finding::None) {
+            log.add(tracks[index], results[index]);
+          }
+        });
+      }
+      pool.wait();
+
+      std::vector<size_t> order(tracks.size());
+      for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+        played += results[i].ticks;
+        goals += results[i].outcome == RunOutcome::Goal;
+      }
+      std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return fitness(results[a]) > fitness(results[b]);
+      });
+      bestX = std::max(bestX, results[order[0]].maxX);
+      std::cout << "generation " << generation << ": best x "
+                << results[order[0]].maxX << std::endl;
+
+      // Top quarter survives; the rest are mutated crossovers of survivors
+      size_t elite = std::max<size_t>(2, tracks.size() / 4);
+      std::vector<InputTrack> next;
+      next.reserve(tracks.size());
+      for (size_t i = 0; i < elite; ++i) {
+        next.push_back(tracks[order[i]]);
+      }
+      std::uniform_int_distribution<size_t> pick(0, elite - 1);
+      while (next.size() < tracks.size()) {
+        InputTrack child =
+            crossover(next[pick(rng)], next[pick(rng)], rng);
+        next.push_back(mutate(child, rng));
+      }
+      tracks = std::move(next);
+    }
+  }
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << played << " ticks in " << elapsed.count() << " s, " << goals
+            << " goals, best x " << bestX << std::endl;
+
+  // Shrink and save every distinct failure
+  std::vector<Failure> failures = log.all();
+  std::vector<InputTrack> minimized(failures.size());
+  for (size_t index = 0; index < failures.size(); ++index) {
+    pool.submit([&, index]() {
+      minimized[index] =
+          minimize(failures[index].track, failures[index].eval, limits);
+    });
+  }
+  pool.wait();
+
+  for (size_t i = 0; i < failures.size(); ++i) {
+    const Evaluation &eval = failures[i].eval;
+    std::string path = outDir + "/level" + std::to_string(levelNumber) + "-" +
+                       findingName(eval.finding) + "-" + std::to_string(i) +
+                       ".rec";
+    minimized[i].saveToFile(path);
+    std::cout << findingName(eval.finding) << " at tick " << eval.ticks
+              << ", x=" << eval.x << " -> " << path << " ("
+              << minimized[i].runs().size() << " runs)" << std::endl;
+  }
+  if (failures.empty()) {
+    std::cout << "no findings" << std::endl;
+  }
+  return failures.empty() ? 0 : 1;
+}
@@ -0,0 +1,344 @@
+// Headless simulation runner.
+// Plays a level with no window, GPU or audio device: textures are never
+// loaded (TextureCache headless mode) and no AudioSystem exists, so it runs
+// on display-less machines, as fast as the CPU allows.
+//
+// Usage: mario_headless [--level N] [--script FILE] [--replay FILE]
+//                       [--record FILE] [--max-ticks N] [--runs N]
+//                       [--state-bench TICKS] [--check-determinism]
+//                       [--hash-log FILE] [--compare-hashes FILE]
+//                       [--stress SPEC]
+//
+// --script reads a text script (see InputTrack::loadScript), one run per
+// line: "<ticks> <buttons>"
+//   buttons: any combination of L R D J F (left, right, down, jump, fire),
+//            or '-' for no buttons. '#' starts a comment.
+//   Example:   30 -
+//              240 R
+//              12 RJ
+// --replay reads a binary track recorded by the game (--record) and plays
+// the level it was recorded on (stress levels are rebuilt from the spec in
+// the track). --record writes the input of the first run.
+// After the input ends the player receives no input.
+// --state-bench plays TICKS ticks feeding a RewindBuffer (as the game does),
+// then times savestate round trips (GameSession::saveState + loadState) and
+// rewind steps on that world.
+// Determinism checks hash the world every tick (GameSession::hashState):
+// --check-determinism plays the input twice in this process and reports the
+// first tick and subsystem where the runs diverge. --hash-log writes the
+// per-tick hashes of a run as text; --compare-hashes checks this build
+// against a log written by another build (or machine) from the same input.
+// --stress plays a generated stress level instead of --level, e.g.
+// "--stress 7,100000,10000,5000,2000,500" (see StressLevelSpec).
+
+#include "GameSession.hpp"
+#include "InputTrack.hpp"
+#include "RewindBuffer.hpp"
+#include "StateHash.hpp"
+#include "TextureCache.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Numbered level or generated stress level
+struct LevelChoice {
+  int number = 1;
+  bool stress = false;
+  StressLevelSpec spec;
+
+  // Same view size as the game window: spawning follows the camera
+  std::unique_ptr<GameSession> create() const {
+    if (stress) {
+      return std::make_unique<GameSession>(800.0f, 600.0f, spec);
+    }
+    return std::make_unique<GameSession>(800.0f, 600.0f, number);
+  }
+};
+
+void benchSavestate(const LevelChoice &level, const InputTrack &track,
+                    unsigned long ticks) {
+  std::unique_ptr<GameSession> created = level.create();
+  GameSession &session = *created;
+  InputPlayback playback(track);
+  RewindBuffer rewind;
+  std::vector<std::uint8_t> blob;
+  double pushSeconds = 0.0;
+  unsigned long pushes = 0;
+  for (unsigned long tick = 0; tick < ticks && !session.player->isDead();
+       ++tick) {
+    session.step(GameSession::TICK_DT, playback.next());
+    auto t0 = std::chrono::steady_clock::now();
+    session.saveState(blob);
+    rewind.push(blob);
+    pushSeconds += std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - t0)
+                       .count();
+    ++pushes;
+  }
+
+  const int ROUND_TRIPS = 1000;
+  double saveSeconds = 0.0;
+  double loadSeconds = 0.0;
+  for (int i = 0; i < ROUND_TRIPS; ++i) {
+    auto t0 = std::chrono::steady_clock::now();
+    session.saveState(blob);
+    auto t1 = std::chrono::steady_clock::now();
+    if (!session.loadState(blob)) {
+      return;
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    saveSeconds += std::chrono::duration<double>(t1 - t0).count();
+    loadSeconds += std::chrono::duration<double>(t2 - t1).count();
+  }
+
+  std::cout << "savestate: " << blob.size() << " bytes, save "
+            << saveSeconds / ROUND_TRIPS * 1e6 << " us, load "
+            << loadSeconds / ROUND_TRIPS * 1e6 << " us" << std::endl;
+
+  if (pushes > 0) {
+    size_t frames = rewind.frameCount();
+    auto t0 = std::chrono::steady_clock::now();
+    size_t steps = 0;
+    while (rewind.stepBack(blob)) {
+      ++steps;
+    }
+    double stepSeconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - t0)
+                             .count();
+    std::cout << "rewind: " << frames << " frames in "
+              << rewind.byteBudget() / 1024 << " KB budget, save+push "
+              << pushSeconds / pushes * 1e6 << " us, step back "
+              << (steps > 0 ? stepSeconds / steps * 1e6 : 0.0) << " us"
+              << std::endl;
+  }
+}
+
+// Per-tick hashes of one run, stopping like runSession does
+std::vector<StateHash> hashRun(const LevelChoice &level,
+                               const InputTrack &track,
+                               unsigned long maxTicks) {
+  std::unique_ptr<GameSession> created = level.create();
+  GameSession &session = *created;
+  InputPlayback playback(track);
+  std::vector<StateHash> hashes;
+  for (unsigned long tick = 0; tick < maxTicks; ++tick) {
+    session.step(GameSession::TICK_DT, playback.next());
+    hashes.push_back(session.hashState());
+    if (session.player->isDead() || session.isLevelComplete()) {
+      break;
+    }
+  }
+  return hashes;
+}
+
+// One line per tick: tick, combined hash, then one hash per subsystem (hex)
+bool writeHashLog(const std::string &path,
+                  const std::vector<StateHash> &hashes) {
+  std::ofstream file(path);
+  if (!file) {
+    std::cerr << "Error writing hash log: " << path << std::endl;
+    return false;
+  }
+  for (size_t tick = 0; tick < hashes.size(); ++tick) {
+    file << std::dec << tick << std::hex << ' ' << hashes[tick].combined();
+    for (std::uint64_t part : hashes[tick].parts) {
+      file << ' ' << part;
+    }
+    file << '\n';
+  }
+  return true;
+}
+
+bool readHashLog(const std::string &path, std::vector<StateHash> &hashes) {
+  std::ifstream file(path);
+  if (!file) {
+    std::cerr << "Error loading hash log: " << path << std::endl;
+    return false;
+  }
+  hashes.clear();
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    unsigned long tick = 0;
+    std::uint64_t combined = 0;
+    StateHash hash;
+    fields >> std::dec >> tick >> std::hex >> combined;
+    for (std::uint64_t &part : hash.parts) {
+      fields >> part;
+    }
+    if (!fields || tick != hashes.size()) {
+      std::cerr << "Error loading hash log: bad line " << hashes.size() + 1
+                << " in " << path << std::endl;
+      return false;
+    }
+    hashes.push_back(hash);
+  }
+  return true;
+}
+
+// Reports the first divergence; true if both runs match tick for tick
+bool compareRuns(const std::vector<StateHash> &expected,
+                 const std::vector<StateHash> &actual) {
+  size_t common = std::min(expected.size(), actual.size());
+  for (size_t tick = 0; tick < common; ++tick) {
+    int subsystem = expected[tick].firstMismatch(actual[tick]);
+    if (subsystem != StateHash::Count) {
+      std::cout << "diverged at tick " << tick << " in "
+                << StateHash::subsystemName(subsystem) << std::endl;
+      return false;
+    }
+  }
+  if (expected.size() != actual.size()) {
+    std::cout << "diverged at tick " << common << ": one run ended ("
+              << expected.size() << " vs " << actual.size() << " ticks)"
+              << std::endl;
+    return false;
+  }
+  std::cout << "deterministic: " << common << " ticks match" << std::endl;
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  LevelChoice level;
+  bool levelGiven = false;
+  std::string scriptPath;
+  std::string replayPath;
+  std::string recordPath;
+  unsigned long maxTicks = 60 * 60 * 5; // 5 minutes of game time
+  int runs = 1;
+  unsigned long stateBenchTicks = 0;
+  bool checkDeterminism = false;
+  std::string hashLogPath;
+  std::string compareHashesPath;
+
+  for (int i = 1; i < argc; ++i) {
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(argv[i], "--level") == 0 && hasValue) {
+      level.number = std::atoi(argv[++i]);
+      levelGiven = true;
+    } else if (std::strcmp(argv[i], "--script") == 0 && hasValue) {
+      scriptPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--replay") == 0 && hasValue) {
+      replayPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+      recordPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--max-ticks") == 0 && hasValue) {
+      maxTicks = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--runs") == 0 && hasValue) {
+      runs = std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--state-bench") == 0 && hasValue) {
+      stateBenchTicks = std::strtoul(argv[++i], nullptr, 10);
+    } else if (std::strcmp(argv[i], "--check-determinism") == 0) {
+      checkDeterminism = true;
+    } else if (std::strcmp(argv[i], "--hash-log") == 0 && hasValue) {
+      hashLogPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--compare-hashes") == 0 && hasValue) {
+      compareHashesPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--stress") == 0 && hasValue) {
+      if (!StressLevelSpec::parse(argv[++i], level.spec)) {
+        return 2;
+      }
+      level.stress = true;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--level N] [--script FILE] [--replay FILE]"
+                   " [--record FILE] [--max-ticks N] [--runs N]"
+                   " [--state-bench TICKS] [--check-determinism]"
+                   " [--hash-log FILE] [--compare-hashes FILE]"
+                   " [--stress SPEC]"
+                << std::endl;
+      return 2;
+    }
+  }
+
+  InputTrack track;
+  if (!replayPath.empty()) {
+    if (!track.loadFromFile(replayPath)) {
+      return 1;
+    }
+    if (!levelGiven) {
+      level.number = track.level();
+    }
+    // A generated level is rebuilt from the spec stored in the track
+    if (track.level() == Level::STRESS_LEVEL && !level.stress) {
+      if (track.stressSpec().empty()) {
+        std::cerr << "Error: " << replayPath
+                  << " is a stress level recorded without its spec; pass the"
+                     " same --stress SPEC" << std::endl;
+        return 2;
+      }
+      if (!StressLevelSpec::parse(track.stressSpec(), level.spec)) {
+        return 2;
+      }
+      level.stress = true;
+    }
+  } else if (!scriptPath.empty() && !track.loadScript(scriptPath)) {
+    return 1;
+  }
+
+  InputTrack record;
+  record.reset(level.stress ? Level::STRESS_LEVEL : level.number);
+  if (level.stress) {
+    record.setStressSpec(level.spec.toString());
+  }
+
+  // No textures, no GL context, no audio device
+  TextureCache::setHeadless(true);
+
+  unsigned long totalTicks = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int run = 0; run < runs; ++run) {
+    InputTrack *recordRun = (run == 0 && !recordPath.empty()) ? &record : nullptr;
+    std::unique_ptr<GameSession> session = level.create();
+    RunResult result = runSession(*session, track, maxTicks, recordRun);
+    totalTicks += result.ticks;
+    std::cout << "run " << run << ": " << outcomeName(result.outcome)
+              << " after " << result.ticks << " ticks, x=" << result.finalX
+              << std::endl;
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  std::cout << totalTicks << " ticks in " << elapsed.count() << " s ("
+            << (elapsed.count() > 0.0 ? totalTicks / elapsed.count() : 0.0)
+            << " ticks/s)" << std::endl;
+
+  if (stateBenchTicks > 0) {
+    benchSavestate(level, track, stateBenchTicks);
+  }
+
+  bool deterministic = true;
+  if (checkDeterminism || !hashLogPath.empty() || !compareHashesPath.empty()) {
+    std::vector<StateHash> hashes = hashRun(level, track, maxTicks);
+    if (!hashLogPath.empty() && !writeHashLog(hashLogPath, hashes)) {
+      return 1;
+    }
+    if (checkDeterminism) {
+      deterministic &=
+          compareRuns(hashes, hashRun(level, track, maxTicks));
+    }
+    if (!compareHashesPath.empty()) {
+      std::vector<StateHash> expected;
+      if (!readHashLog(compareHashesPath, expected)) {
+        return 1;
+      }
+      deterministic &= compareRuns(expected, hashes);
+    }
+  }
+
+  if (!recordPath.empty() && !record.saveToFile(recordPath)) {
+    return 1;
+  }
+  return deterministic ? 0 : 3;
+}
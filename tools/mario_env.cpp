@@ -0,0 +1,249 @@
+// libmario_env: C API around headless GameSessions (see mario_env.h)
+
+#include "mario_env.h"
+#include "GameSession.hpp"
+#include "Koopa.hpp"
+#include "TextureCache.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(MarioObservation) % 4 == 0,
+              "MarioObservation must stay 4-byte packed for foreign readers");
+
+struct MarioEnv {
+  std::unique_ptr<GameSession> session;
+  MarioObservation *obs = nullptr;
+  std::uint32_t tick = 0;
+  float lastX = 0.0f;
+  int done = 0;
+  // Reused every step, so observing does not allocate
+  std::vector<MarioEnemyObs> enemyScratch;
+};
+
+namespace {
+
+const float VIEW_WIDTH = 800.0f;
+const float VIEW_HEIGHT = 600.0f;
+const int MAX_IDLE_TICKS = 30;
+
+void writeObservation(MarioEnv &env, float reward) {
+  if (!env.obs) {
+    return;
+  }
+  MarioObservation &obs = *env.obs;
+  const Player &player = *env.session->player;
+  sf::Vector2f pos = player.getPosition();
+  b2Vec2 vel = player.getVelocity();
+
+  obs.tick = env.tick;
+  obs.reward = reward;
+  obs.done = static_cast<std::uint8_t>(env.done);
+  obs.big = player.isBig() ? 1 : 0;
+  obs.fire = player.isFireMario() ? 1 : 0;
+  obs.pad = 0;
+  obs.x = pos.x;
+  obs.y = pos.y;
+  obs.vx = vel.x * Physics::SCALE;
+  obs.vy = vel.y * Physics::SCALE;
+
+  // Grid centered on the player's cell
+  float left = pos.x - (MARIO_OBS_GRID_W / 2 + 0.5f) * MARIO_OBS_CELL;
+  float top = pos.y - (MARIO_OBS_GRID_H / 2 + 0.5f) * MARIO_OBS_CELL;
+  env.session->level->rasterize(left, top, MARIO_OBS_CELL, MARIO_OBS_GRID_W,
+                                MARIO_OBS_GRID_H, &obs.grid[0][0]);
+
+  // Nearest enemies first
+  std::vector<MarioEnemyObs> &enemies = env.enemyScratch;
+  enemies.clear();
+  for (const auto &enemy : env.session->level->getEnemies()) {
+    if (!enemy->isAlive()) {
+      continue;
+    }
+    sf::Vector2f enemyPos = enemy->getPosition();
+    b2Vec2 enemyVel = enemy->getVelocity();
+    MarioEnemyObs entry{};
+    entry.dx = enemyPos.x - pos.x;
+    entry.dy = enemyPos.y - pos.y;
+    entry.vx = enemyVel.x * Physics::SCALE;
+    entry.vy = enemyVel.y * Physics::SCALE;
+    entry.kind = dynamic_cast<const Koopa *>(enemy.get()) ? 1 : 0;
+    entry.stomped = enemy->isStomped() ? 1 : 0;
+    enemies.push_back(entry);
+  }
+  size_t count = std::min<size_t>(enemies.size(), MARIO_OBS_MAX_ENEMIES);
+  std::partial_sort(enemies.begin(), enemies.begin() + count, enemies.end(),
+                    [](const MarioEnemyObs &a, const MarioEnemyObs &b) {
+                      return a.dx * a.dx + a.dy * a.dy <
+                             b.dx * b.dx + b.dy * b.dy;
+                    });
+  obs.enemyCount = static_cast<std::uint32_t>(count);
+  std::copy(enemies.begin(), enemies.begin() + count, obs.enemies);
+  std::fill(obs.enemies + count, obs.enemies + MARIO_OBS_MAX_ENEMIES,
+            MarioEnemyObs{});
+}
+
+// Shared by every mario_env_step_many call; rebuilt if the size changes
+std::mutex s_poolMutex;
+std::unique_ptr<ThreadPool> s_pool;
+size_t s_poolThreads = 0;
+
+} // namespace
+
+extern "C" {
+
+MarioEnv *mario_env_create(MarioObservation *obs) {
+  // No textures, no GL context, no audio device
+  TextureCache::setHeadless(true);
+
+  MarioEnv *env = new MarioEnv();
+  env->obs = obs;
+  env->enemyScratch.reserve(64);
+  return env;
+}
+
+void mario_env_destroy(MarioEnv *env) { delete env; }
+
+void mario_env_set_observation(MarioEnv *env, MarioObservation *obs) {
+  env->obs = obs;
+}
+
+int mario_env_reset(MarioEnv *env, int level, uint32_t seed) {
+  if (level < 1 || level > 2) {
+    std::cerr << "mario_env_reset: unknown level " << level << std::endl;
+    return -1;
+  }
+  env->session = std::make_unique<GameSession>(VIEW_WIDTH, VIEW_HEIGHT, level);
+  env->tick = 0;
+  env->done = 0;
+
+  std::mt19937 rng(seed);
+  int idleTicks = std::uniform_int_distribution<int>(0, MAX_IDLE_TICKS)(rng);
+  for (int i = 0; i < idleTicks; ++i) {
+    env->session->step(GameSession::TICK_DT, InputState());
+  }
+
+  env->lastX = env->session->player->getPosition().x;
+  writeObservation(*env, 0.0f);
+  return 0;
+}
+
+int mario_env_step(MarioEnv *env, uint32_t actions, uint32_t ticks) {
+  if (!env->session) {
+    mario_env_reset(env, 1, 0);
+  }
+
+  InputState input;
+  input.buttons = static_cast<std::uint8_t>(actions);
+  GameSession &session = *env->session;
+  for (uint32_t i = 0; i < ticks && env->done == 0; ++i) {
+    session.step(GameSession::TICK_DT, input);
+    ++env->tick;
+    if (session.player->isDead()) {
+      env->done = 2;
+    } else if (session.level->isGoalReached()) {
+      env->done = 1;
+    }
+  }
+
+  float x = session.player->getPosition().x;
+  writeObservation(*env, x - env->lastX);
+  env->lastX = x;
+  return env->done;
+}
+
+void mario_env_step_many(MarioEnv **envs, const uint32_t *actions,
+                         size_t count, uint32_t ticks, uint32_t threads) {
+  std::lock_guard<std::mutex> lock(s_poolMutex);
+  if (!s_pool || (threads != 0 && threads != s_poolThreads)) {
+    s_pool.reset();
+    s_pool = std::make_unique<ThreadPool>(threads);
+    s_poolThreads = s_pool->size();
+  }
+  // Environments are independent: one job each, no shared state
+  for (size_t i = 0; i < count; ++i) {
+    MarioEnv *env = envs[i];
+    uint32_t action = actions[i];
+    s_pool->submit([env, action, ticks]() { mario_env_step(env, action, ticks); });
+  }
+  s_pool->wait();
+}
+
+size_t mario_observation_size(void) { return sizeof(MarioObservation); }
+
+#ifdef _WIN32
+
+MarioObservation *mario_shm_open(const char *name, size_t count, int create) {
+  size_t bytes = count * sizeof(MarioObservation);
+  HANDLE mapping =
+      create ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                  static_cast<DWORD>((uint64_t)bytes >> 32),
+                                  static_cast<DWORD>(bytes & 0xFFFFFFFFu), name)
+             : OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+  if (!mapping) {
+    std::cerr << "Error opening shared memory " << name << std::endl;
+    return nullptr;
+  }
+  void *view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+  // The view keeps the section alive
+  CloseHandle(mapping);
+  return static_cast<MarioObservation *>(view);
+}
+
+void mario_shm_close(MarioObservation *obs, size_t count) {
+  if (obs) {
+    UnmapViewOfFile(obs);
+  }
+}
+
+void mario_shm_unlink(const char *name) {
+  // Named sections disappear with their last view
+}
+
+#else
+
+MarioObservation *mario_shm_open(const char *name, size_t count, int create) {
+  size_t bytes = count * sizeof(MarioObservation);
+  int fd = shm_open(name, create ? (O_CREAT | O_RDWR) : O_RDWR, 0600);
+  if (fd < 0) {
+    std::cerr << "Error opening shared memory " << name << std::endl;
+    return nullptr;
+  }
+  if (create && ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+    std::cerr << "Error sizing shared memory " << name << std::endl;
+    close(fd);
+    return nullptr;
+  }
+  void *memory =
+      mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    std::cerr << "Error mapping shared memory " << name << std::endl;
+    return nullptr;
+  }
+  return static_cast<MarioObservation *>(memory);
+}
+
+void mario_shm_close(MarioObservation *obs, size_t count) {
+  if (obs) {
+    munmap(obs, count * sizeof(MarioObservation));
+  }
+}
+
+void mario_shm_unlink(const char *name) { shm_unlink(name); }
+
+#endif
+
+} // extern "C"
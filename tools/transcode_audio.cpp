@@ -0,0 +1,65 @@
+// Audio transcoder: writes every PcmAsset (short sound effects) to disk as
+// raw 16-bit PCM. Runs at build time (make assets) so the game maps the
+// samples straight into its sound buffers instead of decoding MP3/Vorbis
+// at startup. Needs no audio device.
+//
+// Usage: transcode_audio [--out DIR] [--list]
+//
+// Run from the repository root (source paths are relative to it). --out
+// defaults to assets/pcm, where SoundBufferCache looks; --list only prints
+// the assets.
+
+#include "PcmAssets.hpp"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+int main(int argc, char **argv) {
+  std::string outDir = "assets/pcm";
+  bool listOnly = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+      outDir = argv[++i];
+    } else if (std::strcmp(argv[i], "--list") == 0) {
+      listOnly = true;
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [--out DIR] [--list]"
+                << std::endl;
+      return 2;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::create_directories(outDir, error);
+  if (error) {
+    std::cerr << "Error creating " << outDir << ": " << error.message()
+              << std::endl;
+    return 1;
+  }
+
+  int failures = 0;
+  for (const PcmAsset &asset : PcmAsset::all()) {
+    if (listOnly) {
+      std::cout << asset.name << ": " << asset.source << std::endl;
+      continue;
+    }
+    sf::SoundBuffer buffer;
+    if (!buffer.loadFromFile(asset.source)) {
+      std::cerr << "Error loading " << asset.source << std::endl;
+      ++failures;
+      continue;
+    }
+    std::cout << asset.name << ": " << asset.source << " -> "
+              << buffer.getChannelCount() << " channel(s), "
+              << buffer.getSampleRate() << " Hz, "
+              << buffer.getSampleCount() * sizeof(std::int16_t) << " bytes"
+              << std::endl;
+    std::string path = outDir + "/" + asset.name + ".pcm";
+    if (!PcmAsset::write(path, buffer)) {
+      std::cerr << "Error writing " << path << std::endl;
+      ++failures;
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}